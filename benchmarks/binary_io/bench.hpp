@@ -0,0 +1,110 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+
+#include "binary_io/common.hpp"
+
+#if BINARY_IO_OS_LINUX
+#	include <linux/perf_event.h>
+#	include <sys/ioctl.h>
+#	include <sys/syscall.h>
+#	include <unistd.h>
+#endif
+
+namespace bench
+{
+	// counts a hardware event for the calling thread, where the platform allows it
+	class counter
+	{
+	public:
+		enum class event
+		{
+			dtlb_misses,
+			llc_misses,
+		};
+
+		explicit counter([[maybe_unused]] event a_event) noexcept
+		{
+#if BINARY_IO_OS_LINUX
+			::perf_event_attr attr = {};
+			attr.size = sizeof(attr);
+			attr.type = PERF_TYPE_HW_CACHE;
+			attr.config =
+				(a_event == event::dtlb_misses ? PERF_COUNT_HW_CACHE_DTLB : PERF_COUNT_HW_CACHE_LL) |
+				(PERF_COUNT_HW_CACHE_OP_READ << 8) |
+				(PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+			attr.disabled = 1;
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			this->_fd = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+		}
+
+		counter(const counter&) = delete;
+		counter& operator=(const counter&) = delete;
+
+		~counter() noexcept
+		{
+#if BINARY_IO_OS_LINUX
+			if (this->_fd != -1) {
+				::close(this->_fd);
+			}
+#endif
+		}
+
+		void start() noexcept
+		{
+#if BINARY_IO_OS_LINUX
+			if (this->_fd != -1) {
+				::ioctl(this->_fd, PERF_EVENT_IOC_RESET, 0);
+				::ioctl(this->_fd, PERF_EVENT_IOC_ENABLE, 0);
+			}
+#endif
+		}
+
+		[[nodiscard]] std::optional<std::uint64_t> stop() noexcept
+		{
+#if BINARY_IO_OS_LINUX
+			std::uint64_t result = 0;
+			if (this->_fd != -1) {
+				::ioctl(this->_fd, PERF_EVENT_IOC_DISABLE, 0);
+				if (::read(this->_fd, &result, sizeof(result)) == sizeof(result)) {
+					return result;
+				}
+			}
+#endif
+			return std::nullopt;
+		}
+
+	private:
+#if BINARY_IO_OS_LINUX
+		int _fd{ -1 };
+#endif
+	};
+
+	// runs the given function once, then prints how long it took and how many events it caused
+	template <class F>
+	void measure(const char* a_name, counter::event a_event, F&& a_func)
+	{
+		counter events{ a_event };
+		events.start();
+		const auto start = std::chrono::steady_clock::now();
+		a_func();
+		const auto stop = std::chrono::steady_clock::now();
+		const auto count = events.stop();
+
+		const std::chrono::duration<double, std::milli> elapsed = stop - start;
+		if (count) {
+			std::printf("%-32s %10.2f ms %14llu %s\n",
+				a_name,
+				elapsed.count(),
+				static_cast<unsigned long long>(*count),
+				a_event == counter::event::dtlb_misses ? "dTLB misses" : "LLC misses");
+		} else {
+			std::printf("%-32s %10.2f ms %14s\n", a_name, elapsed.count(), "n/a");
+		}
+	}
+}
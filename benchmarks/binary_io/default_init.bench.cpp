@@ -0,0 +1,36 @@
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "binary_io/binary_io.hpp"
+
+#include "bench.hpp"
+
+namespace
+{
+	constexpr std::size_t payload_size = std::size_t{ 1 } << 29;
+	constexpr std::size_t chunk_size = std::size_t{ 1 } << 16;
+
+	// appends a large payload in chunks, into a buffer whose pages were faulted in up front
+	template <class Container>
+	void appends(const char* a_name, const std::vector<std::byte>& a_payload)
+	{
+		binary_io::basic_memory_ostream<Container> out;
+		out.rdbuf().resize(a_payload.size());
+		out.rdbuf().clear();
+
+		bench::measure(a_name, bench::counter::event::llc_misses, [&]() {
+			const auto payload = std::span{ a_payload };
+			for (std::size_t i = 0; i < payload.size(); i += chunk_size) {
+				out.write_bytes(payload.subspan(i, chunk_size));
+			}
+		});
+	}
+}
+
+int main()
+{
+	const std::vector<std::byte> payload(payload_size, std::byte{ 0xAB });
+	appends<std::vector<std::byte>>("std::vector<std::byte>", payload);
+	appends<binary_io::byte_buffer>("binary_io::byte_buffer", payload);
+}
@@ -0,0 +1,46 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "binary_io/binary_io.hpp"
+
+#include "bench.hpp"
+
+namespace
+{
+	constexpr std::size_t buffer_size = std::size_t{ 1 } << 29;
+	constexpr std::size_t write_count = std::size_t{ 1 } << 24;
+
+	// scatters small writes across a large buffer, which defeats the TLB on regular pages
+	template <class Container>
+	void random_writes(const char* a_name, const std::vector<binary_io::streamoff>& a_offsets)
+	{
+		binary_io::basic_memory_ostream<Container> out;
+		out.seek_absolute(buffer_size - sizeof(std::uint64_t));
+		out.write(std::uint64_t{ 0 });
+		std::fill(out.rdbuf().begin(), out.rdbuf().end(), std::byte{ 0xFF });  // fault every page in up front
+
+		bench::measure(a_name, bench::counter::event::dtlb_misses, [&]() {
+			std::uint64_t value = 0;
+			for (const auto offset : a_offsets) {
+				out.seek_absolute(offset);
+				out.write(value++);
+			}
+		});
+	}
+}
+
+int main()
+{
+	std::mt19937_64 rng{ 0 };
+	std::uniform_int_distribution<binary_io::streamoff> dist{ 0, buffer_size - sizeof(std::uint64_t) };
+	std::vector<binary_io::streamoff> offsets(write_count);
+	for (auto& offset : offsets) {
+		offset = dist(rng);
+	}
+
+	random_writes<std::vector<std::byte>>("std::vector<std::byte>", offsets);
+	random_writes<binary_io::huge_page_buffer>("binary_io::huge_page_buffer", offsets);
+}
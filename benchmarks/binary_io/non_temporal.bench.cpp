@@ -0,0 +1,47 @@
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include "binary_io/binary_io.hpp"
+
+#include "bench.hpp"
+
+namespace
+{
+	constexpr std::size_t blob_size = std::size_t{ 1 } << 22;
+	constexpr std::size_t hot_size = std::size_t{ 1 } << 20;
+	constexpr std::size_t rounds = 512;
+
+	// alternates bulk payload writes with scans of a small, hot working set, which a
+	// cache-polluting copy evicts every round
+	void bulk_writes(const char* a_name, binary_io::cache_hint a_hint)
+	{
+		const std::vector<std::byte> blob(blob_size, std::byte{ 0xAB });
+		std::vector<std::uint64_t> hot(hot_size / sizeof(std::uint64_t), 1);
+		std::vector<std::byte> storage(blob_size);
+		binary_io::span_ostream out{ storage };
+		out.copy_policy({ a_hint });
+
+		std::uint64_t sum = 0;
+		bench::measure(a_name, bench::counter::event::llc_misses, [&]() {
+			for (std::size_t i = 0; i < rounds; ++i) {
+				out.seek_absolute(0);
+				out.write_bytes(blob);
+				for (std::size_t j = 0; j < 16; ++j) {
+					sum += std::accumulate(hot.begin(), hot.end(), std::uint64_t{ 0 });
+				}
+			}
+		});
+
+		if (sum == 0) {
+			std::printf("unreachable\n");
+		}
+	}
+}
+
+int main()
+{
+	bulk_writes("cache_hint::temporal", binary_io::cache_hint::temporal);
+	bulk_writes("cache_hint::non_temporal", binary_io::cache_hint::non_temporal);
+}
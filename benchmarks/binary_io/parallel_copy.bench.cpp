@@ -0,0 +1,36 @@
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "binary_io/binary_io.hpp"
+
+#include "bench.hpp"
+
+namespace
+{
+	constexpr std::size_t payload_size = std::size_t{ 1 } << 30;
+
+	// appends one giant payload into a presized memory stream, so only the copy is timed
+	void giant_write(std::size_t a_concurrency, const std::vector<std::byte>& a_payload)
+	{
+		binary_io::memory_ostream out;
+		out.rdbuf().resize(a_payload.size());
+
+		binary_io::copy_policy policy;
+		policy.concurrency = a_concurrency;
+		out.copy_policy(policy);
+
+		const auto name = "concurrency = " + std::to_string(a_concurrency);
+		bench::measure(name.c_str(), bench::counter::event::llc_misses, [&]() {
+			out.write_bytes(a_payload);
+		});
+	}
+}
+
+int main()
+{
+	const std::vector<std::byte> payload(payload_size, std::byte{ 0xAB });
+	for (const std::size_t concurrency : { 1, 2, 4, 8 }) {
+		giant_write(concurrency, payload);
+	}
+}
@@ -0,0 +1,262 @@
+# Generates C++ read/write functions from a binary_io layout description.
+#
+# Usage: cmake -DINPUT=<layout file> -DOUTPUT=<header file> -P binary_io_generate_layout.cmake
+#
+# Layout syntax (one declaration per line, `#` starts a comment):
+#
+#	namespace <name>                 the namespace to generate into (optional, may be nested with ::)
+#	struct <name> [little|big]       begins a struct, optionally with a fixed endian format
+#		<type> <field>               a scalar field
+#		<type>[<N>] <field>          a fixed size array of scalars
+#		bytes <field> <length>       a std::vector<std::byte>, sized by a previous scalar field
+#		string <field> <length>      a std::string, sized by a previous scalar field
+#		                             (each length field may size only one field)
+#	end                              ends a struct
+#
+# Scalar types are u8, u16, u32, u64, i8, i16, i32 and i64. Runs of consecutive scalar and array
+# fields are read/written with a single batched call. Length fields are written from the size of
+# the data they describe, and writing data too large for its length field throws
+# binary_io::exception. Reading grows variable fields as their bytes arrive, so a corrupt length
+# fails on the exhausted stream rather than allocating for the whole length up front, and a
+# negative length throws binary_io::exception.
+
+if(NOT DEFINED INPUT OR NOT DEFINED OUTPUT)
+	message(FATAL_ERROR "usage: cmake -DINPUT=<layout> -DOUTPUT=<header> -P ${CMAKE_CURRENT_LIST_FILE}")
+endif()
+
+set(SCALAR_u8 "std::uint8_t")
+set(SCALAR_u16 "std::uint16_t")
+set(SCALAR_u32 "std::uint32_t")
+set(SCALAR_u64 "std::uint64_t")
+set(SCALAR_i8 "std::int8_t")
+set(SCALAR_i16 "std::int16_t")
+set(SCALAR_i32 "std::int32_t")
+set(SCALAR_i64 "std::int64_t")
+
+set(NAMESPACE "")
+set(CURRENT "")
+set(BODY "")
+
+function(layout_error LINE_NO MESSAGE)
+	message(FATAL_ERROR "${INPUT}:${LINE_NO}: ${MESSAGE}")
+endfunction()
+
+# flushes the pending batch of fixed size fields into the read/write bodies
+macro(flush_batch)
+	if(BATCH_READ)
+		list(JOIN BATCH_READ ",\n\t\t\t" _args)
+		string(APPEND READ_BODY "\t\tin.read(${ENDIAN_ARG}\n\t\t\t${_args});\n")
+		list(JOIN BATCH_WRITE ",\n\t\t\t" _args)
+		string(APPEND WRITE_BODY "\t\tout.write(${ENDIAN_ARG}\n\t\t\t${_args});\n")
+		set(BATCH_READ "")
+		set(BATCH_WRITE "")
+	endif()
+endmacro()
+
+macro(begin_struct NAME ENDIAN)
+	set(CURRENT "${NAME}")
+	set(MEMBERS "")
+	set(READ_BODY "")
+	set(WRITE_BODY "")
+	set(BATCH_READ "")
+	set(BATCH_WRITE "")
+	set(SCALARS "")
+	set(LENGTHS "")
+	if("${ENDIAN}" STREQUAL "")
+		set(ENDIAN_ARG "")
+	else()
+		set(ENDIAN_ARG "\n\t\t\tstd::endian::${ENDIAN},")
+	endif()
+endmacro()
+
+macro(end_struct)
+	flush_batch()
+
+	# length fields are written from the size of the container they describe, so they can never
+	# disagree with the data that follows them. containers too large for their length field are
+	# rejected before anything is written
+	set(_checks "")
+	foreach(_field IN LISTS SCALARS)
+		list(FIND LENGTHS "${_field}" _idx)
+		if(_idx EQUAL -1)
+			set("WRITE_${_field}" "a_value.${_field}")
+		else()
+			set(_container "a_value.${LENGTH_OF_${_field}}")
+			set("WRITE_${_field}" "static_cast<${TYPE_OF_${_field}}>(${_container}.size())")
+			string(APPEND _checks
+				"\t\tif (std::cmp_greater(${_container}.size(), std::numeric_limits<${TYPE_OF_${_field}}>::max())) {\n"
+				"\t\t\tthrow binary_io::exception(\"'${LENGTH_OF_${_field}}' is too large for its length field\");\n"
+				"\t\t}\n")
+		endif()
+	endforeach()
+	string(CONFIGURE "${_checks}${WRITE_BODY}" WRITE_BODY @ONLY)
+
+	string(APPEND BODY
+		"\tstruct ${CURRENT}\n"
+		"\t{\n"
+		"${MEMBERS}"
+		"\t};\n"
+		"\n"
+		"\ttemplate <class Derived>\n"
+		"\tvoid read(binary_io::istream_interface<Derived>& a_in, ${CURRENT}& a_value)\n"
+		"\t{\n"
+		"\t\tauto& in = static_cast<Derived&>(a_in);\n"
+		"${READ_BODY}"
+		"\t}\n"
+		"\n"
+		"\ttemplate <class Derived>\n"
+		"\tvoid write(binary_io::ostream_interface<Derived>& a_out, const ${CURRENT}& a_value)\n"
+		"\t{\n"
+		"\t\tauto& out = static_cast<Derived&>(a_out);\n"
+		"${WRITE_BODY}"
+		"\t}\n"
+		"\n")
+	set(CURRENT "")
+endmacro()
+
+file(STRINGS "${INPUT}" LINES)
+set(LINE_NO 0)
+foreach(LINE IN LISTS LINES)
+	math(EXPR LINE_NO "${LINE_NO} + 1")
+	string(REGEX REPLACE "#.*$" "" LINE "${LINE}")
+	string(STRIP "${LINE}" LINE)
+	if("${LINE}" STREQUAL "")
+		continue()
+	endif()
+	string(REGEX REPLACE "[ \t]+" ";" TOKENS "${LINE}")
+	list(LENGTH TOKENS COUNT)
+	list(GET TOKENS 0 KEYWORD)
+
+	if("${KEYWORD}" STREQUAL "namespace")
+		if(NOT COUNT EQUAL 2 OR NOT "${CURRENT}" STREQUAL "" OR NOT "${BODY}" STREQUAL "")
+			layout_error(${LINE_NO} "namespace must be declared once, before any struct")
+		endif()
+		list(GET TOKENS 1 NAMESPACE)
+	elseif("${KEYWORD}" STREQUAL "struct")
+		if(NOT "${CURRENT}" STREQUAL "")
+			layout_error(${LINE_NO} "struct '${CURRENT}' is missing its 'end'")
+		endif()
+		if(COUNT EQUAL 2)
+			list(GET TOKENS 1 NAME)
+			begin_struct("${NAME}" "")
+		elseif(COUNT EQUAL 3)
+			list(GET TOKENS 1 NAME)
+			list(GET TOKENS 2 ENDIAN)
+			if(NOT ENDIAN MATCHES "^(little|big)$")
+				layout_error(${LINE_NO} "unknown endian format '${ENDIAN}'")
+			endif()
+			begin_struct("${NAME}" "${ENDIAN}")
+		else()
+			layout_error(${LINE_NO} "expected 'struct <name> [little|big]'")
+		endif()
+	elseif("${KEYWORD}" STREQUAL "end")
+		if("${CURRENT}" STREQUAL "")
+			layout_error(${LINE_NO} "'end' without a matching 'struct'")
+		endif()
+		end_struct()
+	elseif("${CURRENT}" STREQUAL "")
+		layout_error(${LINE_NO} "field declared outside of a struct")
+	elseif(KEYWORD MATCHES "^(bytes|string)$")
+		if(NOT COUNT EQUAL 3)
+			layout_error(${LINE_NO} "expected '${KEYWORD} <field> <length>'")
+		endif()
+		list(GET TOKENS 1 FIELD)
+		list(GET TOKENS 2 LENGTH)
+		list(FIND SCALARS "${LENGTH}" IDX)
+		if(IDX EQUAL -1)
+			layout_error(${LINE_NO} "length '${LENGTH}' must name a previous scalar field")
+		endif()
+		list(FIND LENGTHS "${LENGTH}" IDX)
+		if(NOT IDX EQUAL -1)
+			layout_error(${LINE_NO} "length '${LENGTH}' already sizes '${LENGTH_OF_${LENGTH}}'")
+		endif()
+		if("${KEYWORD}" STREQUAL "bytes")
+			string(APPEND MEMBERS "\t\tstd::vector<std::byte> ${FIELD};\n")
+		else()
+			string(APPEND MEMBERS "\t\tstd::string ${FIELD};\n")
+		endif()
+		flush_batch()
+		if("${TYPE_OF_${LENGTH}}" MATCHES "^std::int")
+			string(APPEND READ_BODY
+				"\t\tif (a_value.${LENGTH} < 0) {\n"
+				"\t\t\tthrow binary_io::exception(\"'${LENGTH}' is negative\");\n"
+				"\t\t}\n")
+		endif()
+		# the length is untrusted, so the field only grows as fast as its bytes are read
+		string(APPEND READ_BODY
+			"\t\ta_value.${FIELD}.clear();\n"
+			"\t\twhile (a_value.${FIELD}.size() < static_cast<std::size_t>(a_value.${LENGTH})) {\n"
+			"\t\t\tconst auto first = a_value.${FIELD}.size();\n"
+			"\t\t\ta_value.${FIELD}.resize(first + std::min<std::size_t>(static_cast<std::size_t>(a_value.${LENGTH}) - first, 1u << 16));\n"
+			"\t\t\tin.read_bytes(std::as_writable_bytes(std::span{ a_value.${FIELD}.data() + first, a_value.${FIELD}.size() - first }));\n"
+			"\t\t}\n")
+		string(APPEND WRITE_BODY
+			"\t\tout.write_bytes(std::as_bytes(std::span{ a_value.${FIELD}.data(), a_value.${FIELD}.size() }));\n")
+		list(APPEND LENGTHS "${LENGTH}")
+		set("LENGTH_OF_${LENGTH}" "${FIELD}")
+	elseif(KEYWORD MATCHES "^([ui](8|16|32|64))(\\[([0-9]+)\\])?$")
+		set(TYPE "${SCALAR_${CMAKE_MATCH_1}}")
+		set(EXTENT "${CMAKE_MATCH_4}")
+		if(NOT COUNT EQUAL 2)
+			layout_error(${LINE_NO} "expected '${KEYWORD} <field>'")
+		endif()
+		list(GET TOKENS 1 FIELD)
+		if("${EXTENT}" STREQUAL "")
+			string(APPEND MEMBERS "\t\t${TYPE} ${FIELD}{ 0 };\n")
+			list(APPEND BATCH_READ "a_value.${FIELD}")
+			list(APPEND BATCH_WRITE "@WRITE_${FIELD}@")
+			list(APPEND SCALARS "${FIELD}")
+		else()
+			if(EXTENT EQUAL 0)
+				layout_error(${LINE_NO} "array '${FIELD}' must not be empty")
+			endif()
+			string(APPEND MEMBERS "\t\tstd::array<${TYPE}, ${EXTENT}> ${FIELD}{};\n")
+			math(EXPR LAST "${EXTENT} - 1")
+			foreach(I RANGE ${LAST})
+				list(APPEND BATCH_READ "a_value.${FIELD}[${I}]")
+				list(APPEND BATCH_WRITE "a_value.${FIELD}[${I}]")
+			endforeach()
+		endif()
+		set("TYPE_OF_${FIELD}" "${TYPE}")
+	else()
+		layout_error(${LINE_NO} "unknown type '${KEYWORD}'")
+	endif()
+endforeach()
+
+if(NOT "${CURRENT}" STREQUAL "")
+	layout_error(${LINE_NO} "struct '${CURRENT}' is missing its 'end'")
+endif()
+
+get_filename_component(SOURCE_NAME "${INPUT}" NAME)
+string(CONCAT CONTENT
+	"// generated by binary_io from ${SOURCE_NAME}, do not edit\n"
+	"#pragma once\n"
+	"\n"
+	"#include <algorithm>\n"
+	"#include <array>\n"
+	"#include <bit>\n"
+	"#include <cstddef>\n"
+	"#include <cstdint>\n"
+	"#include <limits>\n"
+	"#include <span>\n"
+	"#include <string>\n"
+	"#include <utility>\n"
+	"#include <vector>\n"
+	"\n"
+	"#include <binary_io/common.hpp>\n"
+	"\n")
+string(REGEX REPLACE "\n\n$" "\n" BODY "${BODY}")
+if("${NAMESPACE}" STREQUAL "")
+	string(APPEND CONTENT "${BODY}")
+else()
+	string(APPEND CONTENT "namespace ${NAMESPACE}\n{\n${BODY}}\n")
+endif()
+
+# avoid touching the output when nothing changed, so dependents aren't rebuilt
+if(EXISTS "${OUTPUT}")
+	file(READ "${OUTPUT}" PREVIOUS)
+	if("${PREVIOUS}" STREQUAL "${CONTENT}")
+		return()
+	endif()
+endif()
+file(WRITE "${OUTPUT}" "${CONTENT}")
@@ -0,0 +1,54 @@
+set(BINARY_IO_LAYOUT_GENERATOR "${CMAKE_CURRENT_LIST_DIR}/binary_io_generate_layout.cmake")
+
+# Generates read/write functions for the given layout descriptions, and adds them to a target.
+#
+# binary_io_generate_layouts(
+#	TARGET <target>
+#	[SCOPE <PUBLIC|PRIVATE|INTERFACE>]
+#	[OUTPUT_DIR <dir>]
+#	LAYOUTS <layout>...
+# )
+#
+# Each `<name>.layout` generates `<name>.hpp` into `OUTPUT_DIR` (defaults to
+# `${CMAKE_CURRENT_BINARY_DIR}/binary_io_layouts`), which is added to the target's include
+# directories with the given `SCOPE` (defaults to `PRIVATE`). See binary_io_generate_layout.cmake
+# for the layout syntax.
+function(binary_io_generate_layouts)
+	cmake_parse_arguments(PARSE_ARGV 0 ARG "" "TARGET;SCOPE;OUTPUT_DIR" "LAYOUTS")
+	if(NOT ARG_TARGET)
+		message(FATAL_ERROR "binary_io_generate_layouts: TARGET is required")
+	endif()
+	if(NOT ARG_SCOPE)
+		set(ARG_SCOPE PRIVATE)
+	endif()
+	if(NOT ARG_OUTPUT_DIR)
+		set(ARG_OUTPUT_DIR "${CMAKE_CURRENT_BINARY_DIR}/binary_io_layouts")
+	endif()
+
+	set(OUTPUTS "")
+	foreach(LAYOUT IN LISTS ARG_LAYOUTS)
+		get_filename_component(LAYOUT "${LAYOUT}" ABSOLUTE)
+		get_filename_component(NAME "${LAYOUT}" NAME_WE)
+		set(OUTPUT "${ARG_OUTPUT_DIR}/${NAME}.hpp")
+		add_custom_command(
+			OUTPUT "${OUTPUT}"
+			COMMAND
+				"${CMAKE_COMMAND}"
+				"-DINPUT=${LAYOUT}"
+				"-DOUTPUT=${OUTPUT}"
+				-P "${BINARY_IO_LAYOUT_GENERATOR}"
+			MAIN_DEPENDENCY "${LAYOUT}"
+			DEPENDS "${BINARY_IO_LAYOUT_GENERATOR}"
+			COMMENT "Generating binary_io layout ${NAME}.hpp"
+			VERBATIM
+		)
+		list(APPEND OUTPUTS "${OUTPUT}")
+	endforeach()
+
+	if(ARG_SCOPE STREQUAL "INTERFACE")
+		target_sources("${ARG_TARGET}" INTERFACE ${OUTPUTS})
+	else()
+		target_sources("${ARG_TARGET}" PRIVATE ${OUTPUTS})
+	endif()
+	target_include_directories("${ARG_TARGET}" ${ARG_SCOPE} "$<BUILD_INTERFACE:${ARG_OUTPUT_DIR}>")
+endfunction()
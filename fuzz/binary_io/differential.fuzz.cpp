@@ -0,0 +1,30 @@
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <system_error>
+
+#include "binary_io/differential.hpp"
+
+namespace
+{
+	[[nodiscard]] const std::filesystem::path& scratch_file()
+	{
+		static const auto path = [] {
+			std::error_code ec;
+			auto dir = std::filesystem::temp_directory_path(ec);
+			return (ec ? std::filesystem::path{} : dir) / "binary_io_fuzz_differential.bin";
+		}();
+		return path;
+	}
+}
+
+// interprets the input as a sequence of stream operations, and aborts if any stream disagrees
+// with the reference model
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* a_data, std::size_t a_size)
+{
+	const auto program = std::as_bytes(std::span{ a_data, a_size });
+	const bool files = a_size > 0 && (a_data[0] & 0x80) != 0;
+	differential::run(program, files ? &scratch_file() : nullptr);
+	return 0;
+}
@@ -0,0 +1,62 @@
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "binary_io/binary_io.hpp"
+
+namespace
+{
+	template <class F>
+	void tolerate_exhaustion(F&& a_func)
+	{
+		try {
+			a_func();
+		} catch (const binary_io::exception&) {
+			// malformed input is expected to be rejected with an exception, not a crash
+		}
+	}
+}
+
+// feeds arbitrary input to every parser which walks untrusted data
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* a_data, std::size_t a_size)
+{
+	const auto bytes = std::as_bytes(std::span{ a_data, a_size });
+
+	tolerate_exhaustion([&] {
+		for (const auto& record : binary_io::prefixed_record_range<std::uint16_t>{ bytes }) {
+			if (record.size() >= 4) {
+				(void)record.get<std::uint32_t>(record.size() - 4);
+			}
+		}
+	});
+
+	tolerate_exhaustion([&] {
+		for (const auto record : binary_io::fixed_record_range{ bytes, 7 }) {
+			(void)record.read<std::uint8_t, std::uint16_t, std::uint32_t>(0);
+		}
+	});
+
+	tolerate_exhaustion([&] {
+		binary_io::span_istream in{ bytes };
+		for (auto& chunk : binary_io::chunk_range<binary_io::span_istream, std::uint8_t, std::uint16_t>{ in, 2 }) {
+			// descend one level, like a RIFF LIST chunk
+			for (auto& child : binary_io::chunk_range<binary_io::span_istream>{ chunk.stream }) {
+				(void)child.stream.read_bytes(child.size / 2);
+			}
+		}
+	});
+
+	tolerate_exhaustion([&] {
+		binary_io::span_istream in{ bytes };
+		while (in.tell() < static_cast<binary_io::streamoff>(bytes.size())) {
+			binary_io::versioned_record_reader r{ in };
+			std::uint32_t a = 0;
+			std::uint64_t b = 0;
+			(void)r.read(a);
+			(void)r.read(b);
+			r.finish();
+		}
+	});
+
+	return 0;
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <concepts>
 #include <cstddef>
 #include <memory>
 #include <span>
@@ -118,6 +119,60 @@ namespace binary_io
 				this->_stream.write_bytes(a_src);
 			}
 		};
+
+		struct stream_ref_vtable
+		{
+			void (*flush)(void*) noexcept;
+			void (*seek_absolute)(void*, binary_io::streamoff) noexcept;
+			void (*seek_relative)(void*, binary_io::streamoff) noexcept;
+			binary_io::streamoff (*tell)(const void*) noexcept;
+		};
+
+		template <class Stream>
+		inline constexpr stream_ref_vtable stream_ref_vtable_for{
+			[](void* a_stream) noexcept {
+				if constexpr (concepts::buffered_stream<Stream>) {
+					static_cast<Stream*>(a_stream)->flush();
+				}
+			},
+			[](void* a_stream, binary_io::streamoff a_pos) noexcept {
+				static_cast<Stream*>(a_stream)->seek_absolute(a_pos);
+			},
+			[](void* a_stream, binary_io::streamoff a_off) noexcept {
+				static_cast<Stream*>(a_stream)->seek_relative(a_off);
+			},
+			[](const void* a_stream) noexcept -> binary_io::streamoff {
+				return static_cast<const Stream*>(a_stream)->tell();
+			},
+		};
+
+		struct istream_ref_vtable :
+			public detail::stream_ref_vtable
+		{
+			void (*read_bytes)(void*, std::span<std::byte>);
+		};
+
+		template <class Stream>
+		inline constexpr istream_ref_vtable istream_ref_vtable_for{
+			detail::stream_ref_vtable_for<Stream>,
+			[](void* a_stream, std::span<std::byte> a_dst) {
+				static_cast<Stream*>(a_stream)->read_bytes(a_dst);
+			},
+		};
+
+		struct ostream_ref_vtable :
+			public detail::stream_ref_vtable
+		{
+			void (*write_bytes)(void*, std::span<const std::byte>);
+		};
+
+		template <class Stream>
+		inline constexpr ostream_ref_vtable ostream_ref_vtable_for{
+			detail::stream_ref_vtable_for<Stream>,
+			[](void* a_stream, std::span<const std::byte> a_src) {
+				static_cast<Stream*>(a_stream)->write_bytes(a_src);
+			},
+		};
 	}
 #endif
 
@@ -263,6 +318,49 @@ namespace binary_io
 		protected:
 			std::unique_ptr<StreamBase> _stream;
 		};
+
+		/// \brief Implements the common interface of every `any_stream_ref`.
+		template <class VTable>
+		class any_stream_ref_base
+		{
+		public:
+			/// \name Buffering
+			/// @{
+
+			/// \brief Flushes the referenced stream's buffers, if applicable.
+			void flush() noexcept { this->_vtable->flush(this->_stream); }
+
+			/// @}
+
+			/// \name Position
+			/// @{
+
+			/// \copydoc binary_io::components::basic_seek_stream::seek_absolute()
+			void seek_absolute(binary_io::streamoff a_pos) noexcept
+			{
+				this->_vtable->seek_absolute(this->_stream, a_pos);
+			}
+
+			/// \copydoc binary_io::components::basic_seek_stream::seek_relative()
+			void seek_relative(binary_io::streamoff a_off) noexcept
+			{
+				this->_vtable->seek_relative(this->_stream, a_off);
+			}
+
+			/// \copydoc binary_io::components::basic_seek_stream::tell()
+			[[nodiscard]] binary_io::streamoff tell() const noexcept { return this->_vtable->tell(this->_stream); }
+
+			/// @}
+
+		protected:
+			any_stream_ref_base(void* a_stream, const VTable* a_vtable) noexcept :
+				_stream(a_stream),
+				_vtable(a_vtable)
+			{}
+
+			void* _stream{ nullptr };
+			const VTable* _vtable{ nullptr };
+		};
 	}
 
 	/// \brief A polymorphic stream which can be used to abstract other streams.
@@ -316,4 +414,77 @@ namespace binary_io
 
 		/// @}
 	};
+
+	/// \brief A non-owning reference to any input stream.
+	///
+	/// \remark Unlike \ref any_istream, the referenced stream is neither moved nor allocated:
+	///		the reference is just a pointer to the stream and a pointer to a static table of
+	///		functions which operate on it. It is cheap to copy, and suitable for passing streams
+	///		across non-template interfaces.
+	/// \remark The reference starts out with the default endian format of the referenced stream,
+	///		but changing it afterwards does not affect the referenced stream.
+	class any_istream_ref final :
+		public components::any_stream_ref_base<detail::istream_ref_vtable>,
+		public binary_io::istream_interface<any_istream_ref>
+	{
+	private:
+		using super = components::any_stream_ref_base<detail::istream_ref_vtable>;
+
+	public:
+		/// \brief Refers to the given stream.
+		///
+		/// \param a_stream The stream to refer to. It _must_ outlive the reference.
+		template <class S>
+		requires(
+			!std::same_as<S, any_istream_ref> &&
+			concepts::input_stream<S>)
+			any_istream_ref(S& a_stream) noexcept :
+			super(std::addressof(a_stream), std::addressof(detail::istream_ref_vtable_for<S>))
+		{
+			if constexpr (std::derived_from<S, components::basic_format_stream>) {
+				this->endian(a_stream.endian());
+			}
+		}
+
+		/// \name Reading
+		/// @{
+
+		/// \copydoc span_istream::read_bytes()
+		void read_bytes(std::span<std::byte> a_dst) { this->_vtable->read_bytes(this->_stream, a_dst); }
+
+		/// @}
+	};
+
+	/// \brief A non-owning reference to any output stream.
+	///
+	/// \copydetails any_istream_ref
+	class any_ostream_ref final :
+		public components::any_stream_ref_base<detail::ostream_ref_vtable>,
+		public binary_io::ostream_interface<any_ostream_ref>
+	{
+	private:
+		using super = components::any_stream_ref_base<detail::ostream_ref_vtable>;
+
+	public:
+		/// \copydoc any_istream_ref::any_istream_ref()
+		template <class S>
+		requires(
+			!std::same_as<S, any_ostream_ref> &&
+			concepts::output_stream<S>)
+			any_ostream_ref(S& a_stream) noexcept :
+			super(std::addressof(a_stream), std::addressof(detail::ostream_ref_vtable_for<S>))
+		{
+			if constexpr (std::derived_from<S, components::basic_format_stream>) {
+				this->endian(a_stream.endian());
+			}
+		}
+
+		/// \name Writing
+		/// @{
+
+		/// \copydoc span_ostream::write_bytes()
+		void write_bytes(std::span<const std::byte> a_src) { this->_vtable->write_bytes(this->_stream, a_src); }
+
+		/// @}
+	};
 }
@@ -1,7 +1,24 @@
 #pragma once
 
 #include "binary_io/any_stream.hpp"
+#include "binary_io/byte_buffer.hpp"
+#include "binary_io/chunk_range.hpp"
 #include "binary_io/common.hpp"
+#include "binary_io/copy.hpp"
+#include "binary_io/copy_policy.hpp"
+#include "binary_io/executor.hpp"
 #include "binary_io/file_stream.hpp"
+#include "binary_io/huge_page_buffer.hpp"
+#include "binary_io/mapped_file_stream.hpp"
 #include "binary_io/memory_stream.hpp"
+#include "binary_io/numa.hpp"
+#include "binary_io/pack.hpp"
+#include "binary_io/pipe_stream.hpp"
+#include "binary_io/record_range.hpp"
+#include "binary_io/ring_stream.hpp"
+#include "binary_io/serialize.hpp"
 #include "binary_io/span_stream.hpp"
+#include "binary_io/sub_stream.hpp"
+#include "binary_io/variant_stream.hpp"
+#include "binary_io/versioned_record.hpp"
+#include "binary_io/whole_file.hpp"
@@ -0,0 +1,271 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "binary_io/common.hpp"
+
+namespace binary_io
+{
+	/// \brief A contiguous container of bytes, which can grow without zeroing the bytes it
+	///		grows by.
+	///
+	/// \remark `std::vector` value initializes every element it grows by, so a buffer which is
+	///		grown and then immediately overwritten is written twice. Growing a `byte_buffer`
+	///		with \ref default_init leaves the new bytes uninitialized instead, which halves the
+	///		memory traffic of appending a large payload.
+	/// \remark Any contiguous range of bytes (i.e. `std::vector<std::byte>`) can be explicitly
+	///		copied into a `byte_buffer`, and compares equal to one with the same contents. A
+	///		`byte_buffer` implicitly copies out into a `std::vector<std::byte>`, for APIs which
+	///		expect one.
+	/// \remark The default container of \ref memory_istream and \ref memory_ostream.
+	class byte_buffer
+	{
+	public:
+		using value_type = std::byte;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using reference = value_type&;
+		using const_reference = const value_type&;
+		using pointer = value_type*;
+		using const_pointer = const value_type*;
+		using iterator = pointer;
+		using const_iterator = const_pointer;
+
+		byte_buffer() noexcept = default;
+
+		byte_buffer(const byte_buffer& a_rhs) :
+			byte_buffer(std::span{ a_rhs })
+		{}
+
+		byte_buffer(byte_buffer&& a_rhs) noexcept :
+			_data(std::exchange(a_rhs._data, nullptr)),
+			_size(std::exchange(a_rhs._size, 0)),
+			_capacity(std::exchange(a_rhs._capacity, 0))
+		{}
+
+		/// \brief Constructs a buffer of `a_count` zeroed bytes.
+		///
+		/// \param a_count The size of the buffer.
+		explicit byte_buffer(size_type a_count) { this->resize(a_count); }
+
+		/// \brief Constructs a buffer of `a_count` uninitialized bytes.
+		///
+		/// \param a_count The size of the buffer.
+		byte_buffer(size_type a_count, default_init_t) { this->resize(a_count, default_init); }
+
+		/// \brief Constructs a buffer holding a copy of the given bytes.
+		///
+		/// \param a_bytes The bytes to copy.
+		template <class Range>
+		requires(
+			std::ranges::contiguous_range<const Range> &&
+			std::ranges::sized_range<const Range> &&
+			std::same_as<std::ranges::range_value_t<const Range>, std::byte> &&
+			!std::same_as<std::remove_cvref_t<Range>, byte_buffer>)
+		explicit byte_buffer(const Range& a_bytes)
+		{
+			const auto size = static_cast<size_type>(std::ranges::size(a_bytes));
+			this->resize(size, default_init);
+			if (size != 0) {
+				std::memcpy(this->_data, std::ranges::data(a_bytes), size);
+			}
+		}
+
+		/// \brief Constructs a buffer holding a copy of the bytes in the given range.
+		///
+		/// \param a_first The beginning of the range.
+		/// \param a_last The end of the range.
+		template <std::input_iterator InputIt>
+		byte_buffer(InputIt a_first, InputIt a_last)
+		{
+			if constexpr (std::forward_iterator<InputIt>) {
+				this->reserve(static_cast<size_type>(std::distance(a_first, a_last)));
+			}
+			for (; a_first != a_last; ++a_first) {
+				const auto size = this->_size;
+				this->resize(size + 1, default_init);
+				this->_data[size] = *a_first;
+			}
+		}
+
+		~byte_buffer() noexcept { delete[] this->_data; }
+
+		byte_buffer& operator=(const byte_buffer& a_rhs)
+		{
+			if (this != &a_rhs) {
+				this->resize(a_rhs._size, default_init);
+				if (a_rhs._size != 0) {
+					std::memcpy(this->_data, a_rhs._data, a_rhs._size);
+				}
+			}
+			return *this;
+		}
+
+		byte_buffer& operator=(byte_buffer&& a_rhs) noexcept
+		{
+			if (this != &a_rhs) {
+				delete[] this->_data;
+				this->_data = std::exchange(a_rhs._data, nullptr);
+				this->_size = std::exchange(a_rhs._size, 0);
+				this->_capacity = std::exchange(a_rhs._capacity, 0);
+			}
+			return *this;
+		}
+
+		/// \name Element access
+		/// @{
+
+		[[nodiscard]] reference operator[](size_type a_pos) noexcept
+		{
+			assert(a_pos < this->_size);
+			return this->_data[a_pos];
+		}
+
+		[[nodiscard]] const_reference operator[](size_type a_pos) const noexcept
+		{
+			assert(a_pos < this->_size);
+			return this->_data[a_pos];
+		}
+
+		[[nodiscard]] reference front() noexcept { return (*this)[0]; }
+		[[nodiscard]] const_reference front() const noexcept { return (*this)[0]; }
+
+		[[nodiscard]] reference back() noexcept { return (*this)[this->_size - 1]; }
+		[[nodiscard]] const_reference back() const noexcept { return (*this)[this->_size - 1]; }
+
+		[[nodiscard]] pointer data() noexcept { return this->_data; }
+		[[nodiscard]] const_pointer data() const noexcept { return this->_data; }
+
+		/// @}
+
+		/// \name Iterators
+		/// @{
+
+		[[nodiscard]] iterator begin() noexcept { return this->_data; }
+		[[nodiscard]] const_iterator begin() const noexcept { return this->_data; }
+		[[nodiscard]] const_iterator cbegin() const noexcept { return this->_data; }
+
+		[[nodiscard]] iterator end() noexcept { return this->_data + this->_size; }
+		[[nodiscard]] const_iterator end() const noexcept { return this->_data + this->_size; }
+		[[nodiscard]] const_iterator cend() const noexcept { return this->_data + this->_size; }
+
+		/// @}
+
+		/// \name Capacity
+		/// @{
+
+		[[nodiscard]] bool empty() const noexcept { return this->_size == 0; }
+		[[nodiscard]] size_type size() const noexcept { return this->_size; }
+		[[nodiscard]] size_type capacity() const noexcept { return this->_capacity; }
+
+		/// \brief Ensures the buffer can hold at least `a_capacity` bytes without reallocating.
+		///
+		/// \exception std::bad_alloc Thrown when the memory can not be allocated.
+		/// \param a_capacity The number of bytes to make room for.
+		void reserve(size_type a_capacity)
+		{
+			if (a_capacity <= this->_capacity) {
+				return;
+			}
+
+			const auto data = new std::byte[a_capacity];
+			if (this->_size != 0) {
+				std::memcpy(data, this->_data, this->_size);
+			}
+			delete[] this->_data;
+			this->_data = data;
+			this->_capacity = a_capacity;
+		}
+
+		/// @}
+
+		/// \name Modifiers
+		/// @{
+
+		void clear() noexcept { this->_size = 0; }
+
+		/// \brief Resizes the buffer to hold `a_count` bytes.
+		///
+		/// \remark New bytes are zeroed. The capacity grows geometrically.
+		/// \exception std::bad_alloc Thrown when the memory can not be allocated.
+		/// \param a_count The new size of the buffer.
+		void resize(size_type a_count)
+		{
+			const auto size = this->_size;
+			this->resize(a_count, default_init);
+			if (a_count > size) {
+				std::memset(this->_data + size, 0, a_count - size);
+			}
+		}
+
+		/// \brief Resizes the buffer to hold `a_count` bytes, leaving new bytes uninitialized.
+		///
+		/// \remark The capacity grows geometrically.
+		/// \exception std::bad_alloc Thrown when the memory can not be allocated.
+		/// \param a_count The new size of the buffer.
+		void resize(size_type a_count, default_init_t)
+		{
+			if (a_count > this->_capacity) {
+				this->reserve(std::max(a_count, this->_capacity * 2));
+			}
+			this->_size = a_count;
+		}
+
+		/// \brief Releases any capacity beyond the size of the buffer.
+		///
+		/// \exception std::bad_alloc Thrown when the smaller buffer can not be allocated.
+		void shrink_to_fit()
+		{
+			if (this->_capacity == this->_size) {
+				return;
+			}
+
+			const auto data = this->_size != 0 ? new std::byte[this->_size] : nullptr;
+			if (this->_size != 0) {
+				std::memcpy(data, this->_data, this->_size);
+			}
+			delete[] this->_data;
+			this->_data = data;
+			this->_capacity = this->_size;
+		}
+
+		void swap(byte_buffer& a_rhs) noexcept
+		{
+			std::swap(this->_data, a_rhs._data);
+			std::swap(this->_size, a_rhs._size);
+			std::swap(this->_capacity, a_rhs._capacity);
+		}
+
+		/// @}
+
+		/// \brief Copies the bytes into a `std::vector`.
+		///
+		/// \return A vector holding a copy of the bytes.
+		[[nodiscard]] operator std::vector<std::byte>() const
+		{
+			return { this->begin(), this->end() };
+		}
+
+		[[nodiscard]] friend bool operator==(
+			const byte_buffer& a_lhs,
+			std::span<const std::byte> a_rhs) noexcept
+		{
+			return a_lhs._size == a_rhs.size() &&
+			       (a_lhs._size == 0 || std::memcmp(a_lhs._data, a_rhs.data(), a_lhs._size) == 0);
+		}
+
+	private:
+		std::byte* _data{ nullptr };
+		std::size_t _size{ 0 };
+		std::size_t _capacity{ 0 };
+	};
+}
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <span>
+#include <type_traits>
+
+#include "binary_io/common.hpp"
+#include "binary_io/span_stream.hpp"
+#include "binary_io/sub_stream.hpp"
+
+namespace binary_io
+{
+	/// \brief A single pass range over the tag-length-value chunks of an input stream (i.e. RIFF/IFF).
+	///
+	/// \remark Each chunk is a `Tag`, followed by a `Length`, followed by `Length` bytes of data.
+	///		Iteration ends when the stream is exhausted at a chunk boundary.
+	/// \remark A chunk whose data runs past the end of the stream is rejected as soon as it is
+	///		reached. Where chunk data can't be taken from the stream directly, this costs a read of
+	///		the chunk's last byte.
+	/// \remark Advancing the range skips whatever is left of the current chunk with a single seek,
+	///		regardless of how much of it was consumed.
+	/// \tparam Stream A stream type which meets the requirements of \ref binary_io::concepts::input_stream.
+	///		Chunk data is yielded as a no-copy \ref binary_io::span_istream when `Stream` meets the
+	///		requirements of \ref binary_io::concepts::no_copy_input_stream, or as a
+	///		\ref binary_io::sub_istream otherwise.
+	/// \tparam Tag The type of the chunk tag.
+	/// \tparam Length The type of the chunk length.
+	template <
+		class Stream,
+		class Tag = std::uint32_t,
+		class Length = std::uint32_t>
+	class chunk_range
+	{
+	public:
+		static_assert(concepts::integral<Tag>);
+		static_assert(concepts::integral<Length>);
+
+		using stream_type = Stream;
+		using substream_type = std::conditional_t<
+			concepts::no_copy_input_stream<stream_type>,
+			binary_io::span_istream,
+			binary_io::sub_istream<stream_type>>;
+
+		/// \brief A single chunk yielded by the range.
+		struct chunk
+		{
+			Tag tag{};
+			std::size_t size{ 0 };
+			substream_type stream;
+		};
+
+		class iterator
+		{
+		public:
+			using value_type = chunk;
+			using difference_type = std::ptrdiff_t;
+			using reference = chunk&;
+			using iterator_concept = std::input_iterator_tag;
+
+			iterator() noexcept = default;
+			explicit iterator(chunk_range& a_range) noexcept :
+				_range(std::addressof(a_range))
+			{}
+
+			[[nodiscard]] reference operator*() const noexcept { return *this->_range->_current; }
+			[[nodiscard]] chunk* operator->() const noexcept { return std::addressof(**this); }
+
+			iterator& operator++()
+			{
+				this->_range->next();
+				return *this;
+			}
+
+			void operator++(int) { ++*this; }
+
+			[[nodiscard]] friend bool operator==(const iterator& a_lhs, std::default_sentinel_t) noexcept
+			{
+				return a_lhs.done();
+			}
+
+		private:
+			[[nodiscard]] bool done() const noexcept { return this->_range == nullptr || !this->_range->_current; }
+
+			chunk_range* _range{ nullptr };
+		};
+
+		/// \brief Constructs a range over the given stream, using its default endian format.
+		///
+		/// \param a_in The stream to read chunks from, starting at its current position.
+		///		It _must_ outlive the range.
+		/// \param a_alignment The alignment chunk data is padded to, relative to its start.
+		explicit chunk_range(
+			stream_type& a_in,
+			std::size_t a_alignment = 1) noexcept :
+			chunk_range(a_in, default_endian(a_in), a_alignment)
+		{}
+
+		/// \brief Constructs a range over the given stream.
+		///
+		/// \param a_in The stream to read chunks from, starting at its current position.
+		///		It _must_ outlive the range.
+		/// \param a_endian The endian format chunk headers are stored in, and the default endian
+		///		format of the yielded substreams.
+		/// \param a_alignment The alignment chunk data is padded to, relative to its start.
+		chunk_range(
+			stream_type& a_in,
+			std::endian a_endian,
+			std::size_t a_alignment = 1) noexcept :
+			_in(std::addressof(a_in)),
+			_next(a_in.tell()),
+			_alignment(a_alignment != 0 ? a_alignment : 1),
+			_endian(a_endian)
+		{}
+
+		chunk_range(const chunk_range&) = delete;
+		chunk_range& operator=(const chunk_range&) = delete;
+
+		/// \brief Reads the first chunk.
+		///
+		/// \exception binary_io::buffer_exhausted Thrown when the first chunk is truncated.
+		/// \exception binary_io::exception Thrown when the first chunk is too large to address.
+		[[nodiscard]] iterator begin()
+		{
+			this->next();
+			return iterator{ *this };
+		}
+
+		[[nodiscard]] std::default_sentinel_t end() const noexcept { return std::default_sentinel; }
+
+	private:
+		[[nodiscard]] static std::endian default_endian(const stream_type& a_in) noexcept
+		{
+			if constexpr (requires { { a_in.endian() } -> std::same_as<std::endian>; }) {
+				return a_in.endian();
+			} else {
+				return std::endian::native;
+			}
+		}
+
+		void next()
+		{
+			this->_current.reset();
+			this->_in->seek_absolute(this->_next);
+
+			constexpr auto header_size = sizeof(Tag) + sizeof(Length);
+			std::array<std::byte, header_size> header{};
+			try {
+				this->_in->read_bytes(std::span{ header });
+			} catch (const binary_io::buffer_exhausted&) {
+				// streams differ in how far they advance on a short read, so probe for a single
+				// byte from the start of the header: only a stream with nothing left has ended
+				this->_in->seek_absolute(this->_next);
+				try {
+					this->_in->read_bytes(std::span{ header }.first(1));
+				} catch (const binary_io::buffer_exhausted&) {
+					this->_in->seek_absolute(this->_next);
+					return;
+				}
+				throw;
+			}
+
+			const auto bytes = std::span{ header };
+			const auto tag = binary_io::read<Tag>(
+				bytes.template subspan<0, sizeof(Tag)>(),
+				this->_endian);
+			const auto length = binary_io::read<Length>(
+				bytes.template subspan<sizeof(Tag), sizeof(Length)>(),
+				this->_endian);
+
+			// the size comes straight from the input, so it must be checked before the end of the
+			// chunk is computed from it
+			using raw_length = typename std::conditional_t<
+				std::is_enum_v<Length>,
+				std::underlying_type<Length>,
+				std::type_identity<Length>>::type;
+			const auto raw = static_cast<raw_length>(length);
+			bool negative = false;
+			if constexpr (std::is_signed_v<raw_length>) {
+				negative = raw < 0;
+			}
+
+			constexpr auto max_offset = static_cast<std::size_t>(std::numeric_limits<binary_io::streamoff>::max());
+			if (negative ||
+				static_cast<std::uintmax_t>(raw) > max_offset ||
+				static_cast<std::size_t>(this->_next) > max_offset - header_size) {
+				throw binary_io::exception("chunk is too large");
+			}
+
+			const auto size = static_cast<std::size_t>(raw);
+			const auto start = this->_next + static_cast<binary_io::streamoff>(header_size);
+			const auto padding = (this->_alignment - size % this->_alignment) % this->_alignment;
+			const auto room = max_offset - static_cast<std::size_t>(start);
+			if (size > room || padding > room - size) {
+				throw binary_io::exception("chunk is too large");
+			}
+
+			if constexpr (concepts::no_copy_input_stream<stream_type>) {
+				this->_current = chunk{ tag, size, substream_type{ this->_in->read_bytes(size) } };
+			} else {
+				if (size != 0) {
+					std::array<std::byte, 1> last{};
+					this->_in->seek_absolute(start + static_cast<binary_io::streamoff>(size - 1));
+					this->_in->read_bytes(std::span{ last });
+				}
+				this->_current = chunk{ tag, size, substream_type{ *this->_in, start, size } };
+			}
+			this->_current->stream.endian(this->_endian);
+			this->_next = start + static_cast<binary_io::streamoff>(size + padding);
+		}
+
+		stream_type* _in{ nullptr };
+		std::optional<chunk> _current;
+		binary_io::streamoff _next{ 0 };
+		std::size_t _alignment{ 1 };
+		std::endian _endian{ std::endian::native };
+	};
+}
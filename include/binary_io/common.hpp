@@ -53,6 +53,20 @@ static_assert(
 #	define BINARY_IO_OS_WINDOWS false
 #endif
 
+#if defined(__linux__)
+#	define BINARY_IO_OS_LINUX true
+#else
+#	define BINARY_IO_OS_LINUX false
+#endif
+
+#if defined(__SSE2__) || \
+	defined(_M_X64) ||   \
+	(defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#	define BINARY_IO_ARCH_SSE2 true
+#else
+#	define BINARY_IO_ARCH_SSE2 false
+#endif
+
 #if BINARY_IO_COMP_GNUC || BINARY_IO_COMP_CLANG
 #	define BINARY_IO_VISIBLE __attribute__((visibility("default")))
 #else
@@ -76,6 +90,16 @@ namespace binary_io
 	/// \brief An integral type which can be used to seek any stream.
 	using streamoff = long long;
 
+	/// \brief A tag which asks a container to leave the elements it grows by uninitialized,
+	///		rather than zeroing them.
+	struct default_init_t
+	{
+		explicit default_init_t() = default;
+	};
+
+	/// \brief An instance of \ref default_init_t.
+	inline constexpr default_init_t default_init{};
+
 	namespace concepts
 	{
 #ifdef DOXYGEN
@@ -123,6 +147,49 @@ namespace binary_io
 		};
 #endif
 
+#ifdef DOXYGEN
+		/// \brief A constraint for container types which can be resized without initializing
+		///		the elements they grow by.
+		///
+		/// \remark
+		/// * `T` must provide the following methods:
+		///		* `void resize(T::size_type a_count, binary_io::default_init_t)`
+		template <class T>
+		struct default_init_resizable
+		{};
+#else
+		template <class T>
+		concept default_init_resizable =
+			requires(T a_container, typename T::size_type a_count)
+		{
+			{ a_container.resize(a_count, binary_io::default_init) };
+		};
+#endif
+
+#ifdef DOXYGEN
+		/// \brief A constraint for container types which can release unused capacity.
+		///
+		/// \remark
+		/// * `T` must provide the following methods:
+		///		* `T::size_type capacity() const`
+		///		* `void reserve(T::size_type a_capacity)`
+		///		* `void shrink_to_fit()`
+		template <class T>
+		struct shrinkable
+		{};
+#else
+		template <class T>
+		concept shrinkable =
+			requires(T& a_ref, const T& a_cref, typename T::size_type a_count)
+		{
+			// clang-format off
+			{ a_cref.capacity() } -> std::same_as<typename T::size_type>;
+			{ a_ref.reserve(a_count) };
+			{ a_ref.shrink_to_fit() };
+			// clang-format on
+		};
+#endif
+
 #ifdef DOXYGEN
 		/// \brief A constraint for streams which meet the seekable stream interface.
 		///
@@ -152,6 +219,7 @@ namespace binary_io
 		///		to `flush` to synchronize that buffer.
 		///
 		/// \remark
+		/// * `T` must meet the requirements of \ref binary_io::concepts::seekable_stream.
 		/// * `T` must provide the following methods:
 		///		* `void flush() noexcept`
 		template <class T>
@@ -162,25 +230,45 @@ namespace binary_io
 		concept buffered_stream =
 			seekable_stream<T> &&
 			requires(T& a_ref)
+		{
+			// clang-format off
+			{ a_ref.flush() } noexcept;
+			// clang-format on
+		};
+#endif
+
+#ifdef DOXYGEN
+		/// \brief A constraint for streams which buffer their output, but may fail to synchronize
+		///		it (i.e. pipes and sockets).
+		///
+		/// \remark
+		/// * `T` must provide the following methods:
+		///		* `void flush()`
+		template <class T>
+		struct flushable_stream
+		{};
+#else
+		template <class T>
+		concept flushable_stream =
+			requires(T& a_ref)
 		{
 			{ a_ref.flush() };
 		};
 #endif
 
 #ifdef DOXYGEN
-		/// \brief A constraint for streams which meet the input stream interface.
+		/// \brief A constraint for streams which can be read from front to back, but not necessarily
+		///		seeked (i.e. pipes and sockets).
 		///
 		/// \remark
-		/// * `T` must meet the requirements of \ref binary_io::concepts::seekable_stream.
-		/// * Additionally, `T` must provide the following methods:
+		/// * `T` must provide the following methods:
 		///		* `void read_bytes(std::span<std::byte> a_dst)`
 		template <class T>
-		struct input_stream
+		struct sequential_input_stream
 		{};
 #else
 		template <class T>
-		concept input_stream =
-			seekable_stream<T> &&
+		concept sequential_input_stream =
 			requires(T& a_ref, std::span<std::byte> a_bytes)
 		{
 			{ a_ref.read_bytes(a_bytes) };
@@ -188,25 +276,56 @@ namespace binary_io
 #endif
 
 #ifdef DOXYGEN
-		/// \brief A constraint for streams which meet the output stream interface.
+		/// \brief A constraint for streams which can be written from front to back, but not
+		///		necessarily seeked (i.e. pipes and sockets).
 		///
 		/// \remark
-		/// * `T` must meet the requirements of \ref binary_io::concepts::seekable_stream.
-		/// * Additionally, `T` must provide the following methods:
+		/// * `T` must provide the following methods:
 		///		* `void write_bytes(std::span<const std::byte> a_src)`
 		template <class T>
-		struct output_stream
+		struct sequential_output_stream
 		{};
 #else
 		template <class T>
-		concept output_stream =
-			seekable_stream<T> &&
+		concept sequential_output_stream =
 			requires(T& a_ref, std::span<const std::byte> a_bytes)
 		{
 			{ a_ref.write_bytes(a_bytes) };
 		};
 #endif
 
+#ifdef DOXYGEN
+		/// \brief A constraint for streams which meet the input stream interface.
+		///
+		/// \remark
+		/// * `T` must meet the requirements of \ref binary_io::concepts::seekable_stream
+		///		and \ref binary_io::concepts::sequential_input_stream.
+		template <class T>
+		struct input_stream
+		{};
+#else
+		template <class T>
+		concept input_stream =
+			seekable_stream<T> &&
+			sequential_input_stream<T>;
+#endif
+
+#ifdef DOXYGEN
+		/// \brief A constraint for streams which meet the output stream interface.
+		///
+		/// \remark
+		/// * `T` must meet the requirements of \ref binary_io::concepts::seekable_stream
+		///		and \ref binary_io::concepts::sequential_output_stream.
+		template <class T>
+		struct output_stream
+		{};
+#else
+		template <class T>
+		concept output_stream =
+			seekable_stream<T> &&
+			sequential_output_stream<T>;
+#endif
+
 #ifdef DOXYGEN
 		/// \brief A constraint for streams which provide a `read_bytes` overload which doesn't
 		///		require an intermediate copy.
@@ -228,6 +347,31 @@ namespace binary_io
 			// clang-format on
 		};
 #endif
+
+#ifdef DOXYGEN
+		/// \brief A constraint for streams which can provide a writable window into their
+		///		underlying storage, so that values can be encoded without an intermediate copy.
+		///
+		/// \remark
+		/// * `T` must meet the requirements of \ref binary_io::concepts::sequential_output_stream.
+		/// * Additionally, `T` must provide the following methods:
+		///		* `std::span<std::byte> prepare(std::size_t a_count)`
+		///		* `void commit(std::size_t a_count)`
+		template <class T>
+		struct contiguous_output_stream
+		{};
+#else
+		template <class T>
+		concept contiguous_output_stream =
+			sequential_output_stream<T> &&
+			requires(T& a_ref, std::size_t a_count)
+		{
+			// clang-format off
+			{ a_ref.prepare(a_count) } -> std::same_as<std::span<std::byte>>;
+			{ a_ref.commit(a_count) };
+			// clang-format on
+		};
+#endif
 	}
 
 #ifndef DOXYGEN
@@ -429,7 +573,8 @@ namespace binary_io
 
 	/// \brief A CRTP utility which can be used to flesh out the interface of a given stream.
 	///
-	/// \tparam Derived A stream type which meets the requirements of \ref binary_io::concepts::input_stream.
+	/// \tparam Derived A stream type which meets the requirements of
+	///		\ref binary_io::concepts::sequential_input_stream.
 	template <class Derived>
 	class istream_interface :
 		public components::basic_format_stream
@@ -545,7 +690,7 @@ namespace binary_io
 		{
 #if !BINARY_IO_COMP_CLANG  // WORKAROUND: LLVM-44833
 			static_assert(
-				concepts::input_stream<derived_type>,
+				concepts::sequential_input_stream<derived_type>,
 				"derived type does not meet the minimum requirements for being an input stream");
 #endif
 			return static_cast<derived_type&>(*this);
@@ -579,7 +724,8 @@ namespace binary_io
 
 	/// \copybrief istream_interface
 	///
-	/// \tparam Derived A stream type which meets the requirements of \ref binary_io::concepts::output_stream.
+	/// \tparam Derived A stream type which meets the requirements of
+	///		\ref binary_io::concepts::sequential_output_stream.
 	template <class Derived>
 	class ostream_interface :
 		public components::basic_format_stream
@@ -608,20 +754,22 @@ namespace binary_io
 		void write(std::endian a_endian, Args... a_args)
 		{
 			static_assert((concepts::integral<Args> && ...));
-
 			constexpr auto size = (sizeof(Args) + ...);
-			std::array<std::byte, size> buffer{};
-			const auto bytes = std::span{ buffer };
-
-			std::size_t offset = 0;
-			((binary_io::write(
-				  bytes.subspan(offset, sizeof(Args)).template subspan<0, sizeof(Args)>(),
-				  a_args,
-				  a_endian),
-				 offset += sizeof(Args)),
-				...);
-
-			this->derive().write_bytes(bytes);
+			if constexpr (requires(derived_type& a_ref) { a_ref.prepare(size, binary_io::default_init); }) {
+				// every byte of the window is encoded, so it needn't be zeroed first
+				const auto bytes = this->derive().prepare(size, binary_io::default_init);
+				this->do_write(bytes.template first<size>(), a_endian, a_args...);
+				this->derive().commit(size);
+			} else if constexpr (concepts::contiguous_output_stream<derived_type>) {
+				const auto bytes = this->derive().prepare(size);
+				this->do_write(bytes.template first<size>(), a_endian, a_args...);
+				this->derive().commit(size);
+			} else {
+				std::array<std::byte, size> buffer{};
+				const auto bytes = std::span{ buffer };
+				this->do_write(bytes, a_endian, a_args...);
+				this->derive().write_bytes(bytes);
+			}
 		}
 
 		/// \brief Writes the given value into the output stream.
@@ -664,11 +812,26 @@ namespace binary_io
 		{
 #if !BINARY_IO_COMP_CLANG  // WORKAROUND: LLVM-44833
 			static_assert(
-				concepts::output_stream<derived_type>,
+				concepts::sequential_output_stream<derived_type>,
 				"derived type does not meet the minimum requirements for being an output stream");
 #endif
 			return static_cast<derived_type&>(*this);
 		}
+
+		template <std::size_t N, class... Args>
+		void do_write(
+			std::span<std::byte, N> a_bytes,
+			std::endian a_endian,
+			Args... a_args)
+		{
+			std::size_t offset = 0;
+			((binary_io::write(
+				  a_bytes.subspan(offset, sizeof(Args)).template subspan<0, sizeof(Args)>(),
+				  a_args,
+				  a_endian),
+				 offset += sizeof(Args)),
+				...);
+		}
 	};
 
 	/// \brief The base exception type for all `binary_io` exceptions.
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <span>
+
+#include "binary_io/common.hpp"
+#include "binary_io/file_stream.hpp"
+#include "binary_io/pipe_stream.hpp"
+
+namespace binary_io
+{
+#ifndef DOXYGEN
+	namespace detail
+	{
+		inline constexpr std::size_t copy_buffer_size = 1u << 20;
+
+		template <class In, class Out>
+		void copy_buffered(In& a_in, Out& a_out, std::size_t a_count)
+		{
+			const auto size = std::min(a_count, copy_buffer_size);
+			const std::unique_ptr<std::byte[]> storage{ new std::byte[size] };
+			const std::span buffer{ storage.get(), size };
+
+			while (a_count > 0) {
+				const auto chunk = buffer.first(std::min(a_count, size));
+				a_in.read_bytes(chunk);
+				a_out.write_bytes(chunk);
+				a_count -= chunk.size();
+			}
+		}
+	}
+#endif
+
+	/// \brief Copies `a_count` bytes from the current position of one stream to the current
+	///		position of another.
+	///
+	/// \remark No-copy input streams are written straight from their underlying buffer, and
+	///		contiguous output streams are read straight into theirs. Every other combination
+	///		is copied through a large intermediate buffer.
+	/// \exception binary_io::buffer_exhausted Thrown when the input stream has less than the
+	///		requested number of bytes, or the output stream can not hold them. The contents of
+	///		the output stream are unspecified in this case.
+	/// \param a_in The stream to copy from.
+	/// \param a_out The stream to copy to.
+	/// \param a_count The number of bytes to copy.
+	template <class In, class Out>
+	void copy(In& a_in, Out& a_out, std::size_t a_count)
+	{
+		static_assert(concepts::sequential_input_stream<In>);
+		static_assert(concepts::sequential_output_stream<Out>);
+
+		if (a_count == 0) {
+			return;
+		}
+
+		if constexpr (concepts::no_copy_input_stream<In>) {
+			a_out.write_bytes(a_in.read_bytes(a_count));
+		} else if constexpr (concepts::contiguous_output_stream<Out>) {
+			const auto window = a_out.prepare(a_count);
+			a_in.read_bytes(window);
+			a_out.commit(a_count);
+		} else {
+			detail::copy_buffered(a_in, a_out, a_count);
+		}
+	}
+
+	/// \copybrief copy()
+	///
+	/// \remark Where the platform supports it, the copy is offloaded to the kernel
+	///		(`copy_file_range`, or `sendfile`), so the data never passes through user space.
+	///		Otherwise, the data is copied through a large intermediate buffer.
+	/// \exception binary_io::buffer_exhausted Thrown when the input stream has less than the
+	///		requested number of bytes. The bytes which were available are still copied.
+	/// \exception std::system_error Thrown when the kernel reports an error while copying.
+	/// \pre Both streams _must_ be open.
+	/// \param a_in The stream to copy from.
+	/// \param a_out The stream to copy to.
+	/// \param a_count The number of bytes to copy.
+	void copy(file_istream& a_in, file_ostream& a_out, std::size_t a_count);
+
+	/// \copybrief copy()
+	///
+	/// \remark Bytes the pipe stream has already buffered are written first. Where the platform
+	///		supports it, the rest is moved with `splice`, so the data never passes through user
+	///		space. Otherwise, or when the file descriptor is not a pipe (i.e. a socket), the data
+	///		is copied through a large intermediate buffer.
+	/// \exception binary_io::buffer_exhausted Thrown when the writer closes its end before the
+	///		requested number of bytes have arrived. The bytes which did arrive are still copied.
+	/// \exception std::system_error Thrown when the kernel reports an error while copying.
+	/// \pre Both streams _must_ be open.
+	/// \param a_in The stream to copy from.
+	/// \param a_out The stream to copy to.
+	/// \param a_count The number of bytes to copy.
+	void copy(pipe_istream& a_in, file_ostream& a_out, std::size_t a_count);
+
+	/// \copybrief copy()
+	///
+	/// \remark Bytes the pipe stream has buffered are flushed first. Where the platform supports
+	///		it, the copy is offloaded to the kernel with `sendfile`, which works for sockets as
+	///		well as pipes. Otherwise, the data is copied through a large intermediate buffer.
+	/// \remark Unlike \ref pipe_ostream::write_bytes(), `sendfile` raises `SIGPIPE` for sockets
+	///		as well as pipes whose reader has closed its end.
+	/// \exception binary_io::buffer_exhausted Thrown when the input stream has less than the
+	///		requested number of bytes. The bytes which were available are still copied.
+	/// \exception std::system_error Thrown when the kernel reports an error while copying.
+	/// \pre Both streams _must_ be open.
+	/// \param a_in The stream to copy from.
+	/// \param a_out The stream to copy to.
+	/// \param a_count The number of bytes to copy.
+	void copy(file_istream& a_in, pipe_ostream& a_out, std::size_t a_count);
+}
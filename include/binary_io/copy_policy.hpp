@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+#include "binary_io/common.hpp"
+
+namespace binary_io
+{
+	class executor;
+
+	/// \brief Hints at whether bytes copied into a stream will be read again soon.
+	enum class cache_hint
+	{
+		/// \brief Copies of at least \ref copy_policy::non_temporal_threshold bytes bypass the
+		///		cache, while smaller copies go through it.
+		automatic,
+
+		/// \brief Every copy goes through the cache.
+		temporal,
+
+		/// \brief Every copy bypasses the cache.
+		non_temporal,
+	};
+
+	/// \brief Controls how streams which read or write memory copy bytes.
+	struct copy_policy
+	{
+		/// \brief The default for \ref non_temporal_threshold.
+		///
+		/// \remark Copies this large would evict most of a typical last level cache share.
+		static constexpr std::size_t default_non_temporal_threshold = 1u << 22;
+
+		/// \brief The default for \ref parallel_threshold.
+		static constexpr std::size_t default_parallel_threshold = 1u << 26;
+
+		/// \brief Whether copies should go through the cache.
+		binary_io::cache_hint cache_hint{ binary_io::cache_hint::automatic };
+
+		/// \brief The size at which \ref cache_hint::automatic copies start to bypass the cache.
+		std::size_t non_temporal_threshold{ default_non_temporal_threshold };
+
+		/// \brief The most threads a single copy may be split across.
+		///
+		/// \remark A value of `1` keeps every copy on the calling thread, while `0` allows the
+		///		calling thread plus every thread of the \ref executor. A single core usually can't
+		///		saturate the memory bandwidth of a server, but several can.
+		std::size_t concurrency{ 1 };
+
+		/// \brief The size at which copies start to be split across threads.
+		std::size_t parallel_threshold{ default_parallel_threshold };
+
+		/// \brief The executor which runs the pieces of a split copy.
+		///
+		/// \remark A value of `nullptr` uses \ref default_executor().
+		binary_io::executor* executor{ nullptr };
+	};
+
+	/// \brief Copies bytes from one buffer to another, according to the given policy.
+	///
+	/// \remark Copies which bypass the cache use non-temporal stores, so that a large payload
+	///		which won't be read again soon doesn't evict the rest of the working set. Where the
+	///		platform has no such stores, this is a plain `std::memcpy`.
+	/// \remark Copies of at least \ref copy_policy::parallel_threshold bytes are split into
+	///		cache line aligned pieces, which are copied concurrently. The calling thread copies
+	///		one of the pieces itself, and the copy is complete when this function returns. If the
+	///		pieces can't be handed to the executor, for instance because memory is exhausted, the
+	///		calling thread copies them all.
+	/// \pre `a_dst` _must_ be at least as large as `a_src`, and the two _must not_ overlap.
+	/// \param a_dst The buffer to copy to.
+	/// \param a_src The buffer to copy from.
+	/// \param a_policy The policy to copy with.
+	void copy_bytes(
+		std::span<std::byte> a_dst,
+		std::span<const std::byte> a_src,
+		const copy_policy& a_policy = {}) noexcept;
+
+	namespace components
+	{
+		/// \brief Implements the \ref copy_policy of every stream which copies to or from memory.
+		class basic_copy_stream
+		{
+		public:
+			/// \name Copying
+			/// @{
+
+			/// \brief Gets the policy the stream copies bytes with.
+			///
+			/// \return The copy policy.
+			[[nodiscard]] binary_io::copy_policy copy_policy() const noexcept { return this->_copyPolicy; }
+
+			/// \brief Sets the policy the stream copies bytes with.
+			///
+			/// \param a_policy The new copy policy.
+			void copy_policy(const binary_io::copy_policy& a_policy) noexcept { this->_copyPolicy = a_policy; }
+
+			/// @}
+
+		protected:
+			void copy_bytes(
+				std::span<std::byte> a_dst,
+				std::span<const std::byte> a_src) const noexcept
+			{
+				binary_io::copy_bytes(a_dst, a_src, this->_copyPolicy);
+			}
+
+		private:
+			binary_io::copy_policy _copyPolicy;
+		};
+	}
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+#include "binary_io/common.hpp"
+
+namespace binary_io
+{
+	/// \brief The interface through which every parallel feature of `binary_io` runs its work.
+	///
+	/// \remark Applications which already own a thread pool can implement this interface, and
+	///		install it with \ref set_default_executor(), so that the library never spawns threads
+	///		of its own.
+	/// \remark Parallel features always do part of the work on the calling thread, and never
+	///		block waiting for a task which hasn't started. So an executor may be saturated, or
+	///		used from inside one of its own tasks, without deadlocking.
+	class BINARY_IO_VISIBLE executor
+	{
+	public:
+		virtual ~executor() noexcept = default;
+
+		/// \brief Schedules a task to run on one of the executor's threads.
+		///
+		/// \exception std::bad_alloc Thrown when the task can not be queued.
+		/// \param a_task The task to run. It _must not_ throw.
+		virtual void submit(std::function<void()> a_task) = 0;
+
+		/// \brief Gets the number of tasks the executor can run at once.
+		///
+		/// \return The number of threads the executor runs tasks on.
+		[[nodiscard]] virtual std::size_t concurrency() const noexcept = 0;
+	};
+
+	/// \brief A fixed pool of threads, which balance their work by stealing from each other.
+	///
+	/// \remark Every thread has its own queue. Tasks submitted from one of the pool's threads
+	///		are pushed onto that thread's queue, and run most recent first, which keeps their
+	///		data in cache. Idle threads steal the oldest tasks from the other queues.
+	class work_stealing_executor final :
+		public binary_io::executor
+	{
+	public:
+		/// \brief Starts the pool's threads.
+		///
+		/// \param a_threads The number of threads to start. A value of `0` starts one thread
+		///		per hardware thread.
+		explicit work_stealing_executor(std::size_t a_threads = 0);
+
+		work_stealing_executor(const work_stealing_executor&) = delete;
+		work_stealing_executor(work_stealing_executor&&) = delete;
+
+		/// \brief Runs every queued task, then stops the pool's threads.
+		~work_stealing_executor() noexcept override;
+
+		work_stealing_executor& operator=(const work_stealing_executor&) = delete;
+		work_stealing_executor& operator=(work_stealing_executor&&) = delete;
+
+		/// \copydoc executor::submit()
+		void submit(std::function<void()> a_task) override;
+
+		/// \copydoc executor::concurrency()
+		[[nodiscard]] std::size_t concurrency() const noexcept override;
+
+	private:
+		struct state;
+
+		std::unique_ptr<state> _state;
+	};
+
+	/// \brief Gets the executor which parallel features use when they are not given one.
+	///
+	/// \remark Unless another executor has been installed, this is a process wide
+	///		\ref work_stealing_executor with one thread per hardware thread, which is started the
+	///		first time it is needed.
+	/// \return The default executor.
+	[[nodiscard]] binary_io::executor& default_executor();
+
+	/// \brief Installs the executor which parallel features use when they are not given one.
+	///
+	/// \pre The executor _must_ outlive every use of the library's parallel features.
+	/// \param a_executor The executor to install, or `nullptr` to restore the built-in one.
+	void set_default_executor(binary_io::executor* a_executor) noexcept;
+}
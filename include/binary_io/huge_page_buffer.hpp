@@ -0,0 +1,253 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <utility>
+
+#include "binary_io/common.hpp"
+#include "binary_io/numa.hpp"
+
+namespace binary_io
+{
+	/// \brief A contiguous container of bytes, which moves large buffers onto huge pages.
+	///
+	/// \remark Buffers smaller than \ref mapping_threshold live on the heap. Larger buffers are
+	///		mapped directly from the operating system, preferring explicit huge pages, and
+	///		falling back to regular pages marked as eligible for transparent huge pages. This
+	///		drastically reduces TLB misses when a large buffer is accessed randomly, such as by
+	///		seeking around a \ref basic_memory_ostream.
+	/// \remark Mapped buffers grow in place with `mremap` where the platform supports it, so
+	///		growing never copies the buffer. Memory fresh from the operating system is known to be
+	///		zeroed, so growing only zeroes bytes which were previously in use.
+	/// \remark Mapped buffers are placed according to the buffer's \ref numa_policy. Since
+	///		mapped pages are never touched until they are written, the default first touch
+	///		placement puts them on the node of whichever thread writes them first.
+	/// \remark Meant to be used as the container of a \ref basic_memory_istream or
+	///		\ref basic_memory_ostream.
+	class huge_page_buffer
+	{
+	public:
+		using value_type = std::byte;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using reference = value_type&;
+		using const_reference = const value_type&;
+		using pointer = value_type*;
+		using const_pointer = const value_type*;
+		using iterator = pointer;
+		using const_iterator = const_pointer;
+
+		/// \brief The size of the huge pages large buffers are mapped with.
+		static constexpr std::size_t huge_page_size = 1u << 21;
+
+		/// \brief The capacity at which buffers move from the heap to huge pages.
+		static constexpr std::size_t mapping_threshold = huge_page_size;
+
+		huge_page_buffer() noexcept = default;
+
+		huge_page_buffer(const huge_page_buffer& a_rhs) :
+			_numa(a_rhs._numa)
+		{
+			this->reserve(a_rhs._size);
+			if (a_rhs._size != 0) {
+				std::memcpy(this->_data, a_rhs._data, a_rhs._size);
+			}
+			this->_size = a_rhs._size;
+			this->_dirty = std::max(this->_dirty, this->_size);
+		}
+
+		huge_page_buffer(huge_page_buffer&& a_rhs) noexcept :
+			_data(std::exchange(a_rhs._data, nullptr)),
+			_size(std::exchange(a_rhs._size, 0)),
+			_capacity(std::exchange(a_rhs._capacity, 0)),
+			_dirty(std::exchange(a_rhs._dirty, 0)),
+			_numa(a_rhs._numa),
+			_mapped(std::exchange(a_rhs._mapped, false))
+		{}
+
+		/// \brief Constructs a buffer of `a_count` zeroed bytes.
+		///
+		/// \param a_count The size of the buffer.
+		explicit huge_page_buffer(size_type a_count) :
+			huge_page_buffer()
+		{
+			this->resize(a_count);
+		}
+
+		~huge_page_buffer() noexcept { this->deallocate(); }
+
+		huge_page_buffer& operator=(const huge_page_buffer& a_rhs)
+		{
+			if (this != &a_rhs) {
+				*this = huge_page_buffer(a_rhs);
+			}
+			return *this;
+		}
+
+		huge_page_buffer& operator=(huge_page_buffer&& a_rhs) noexcept
+		{
+			if (this != &a_rhs) {
+				this->deallocate();
+				this->_data = std::exchange(a_rhs._data, nullptr);
+				this->_size = std::exchange(a_rhs._size, 0);
+				this->_capacity = std::exchange(a_rhs._capacity, 0);
+				this->_dirty = std::exchange(a_rhs._dirty, 0);
+				this->_numa = a_rhs._numa;
+				this->_mapped = std::exchange(a_rhs._mapped, false);
+			}
+			return *this;
+		}
+
+		/// \name Element access
+		/// @{
+
+		[[nodiscard]] reference operator[](size_type a_pos) noexcept
+		{
+			assert(a_pos < this->_size);
+			return this->_data[a_pos];
+		}
+
+		[[nodiscard]] const_reference operator[](size_type a_pos) const noexcept
+		{
+			assert(a_pos < this->_size);
+			return this->_data[a_pos];
+		}
+
+		[[nodiscard]] pointer data() noexcept { return this->_data; }
+		[[nodiscard]] const_pointer data() const noexcept { return this->_data; }
+
+		/// @}
+
+		/// \name Iterators
+		/// @{
+
+		[[nodiscard]] iterator begin() noexcept { return this->_data; }
+		[[nodiscard]] const_iterator begin() const noexcept { return this->_data; }
+		[[nodiscard]] const_iterator cbegin() const noexcept { return this->_data; }
+
+		[[nodiscard]] iterator end() noexcept { return this->_data + this->_size; }
+		[[nodiscard]] const_iterator end() const noexcept { return this->_data + this->_size; }
+		[[nodiscard]] const_iterator cend() const noexcept { return this->_data + this->_size; }
+
+		/// @}
+
+		/// \name Capacity
+		/// @{
+
+		[[nodiscard]] bool empty() const noexcept { return this->_size == 0; }
+		[[nodiscard]] size_type size() const noexcept { return this->_size; }
+		[[nodiscard]] size_type capacity() const noexcept { return this->_capacity; }
+
+		/// \brief Checks if the buffer has been moved onto pages mapped from the operating system.
+		///
+		/// \return `true` if the buffer is mapped, `false` if it lives on the heap.
+		[[nodiscard]] bool is_mapped() const noexcept { return this->_mapped; }
+
+		/// \brief Ensures the buffer can hold at least `a_capacity` bytes without reallocating.
+		///
+		/// \remark Capacities of at least \ref mapping_threshold are rounded up to a multiple of
+		///		\ref huge_page_size.
+		/// \exception std::bad_alloc Thrown when the memory can not be allocated.
+		/// \param a_capacity The number of bytes to make room for.
+		void reserve(size_type a_capacity);
+
+		/// \brief Releases any capacity beyond the size of the buffer.
+		///
+		/// \remark Buffers which shrink below \ref mapping_threshold move back onto the heap.
+		///		Mapped buffers are shrunk to a multiple of \ref huge_page_size.
+		/// \exception std::bad_alloc Thrown when the smaller buffer can not be allocated.
+		void shrink_to_fit();
+
+		/// @}
+
+		/// \name Placement
+		/// @{
+
+		/// \brief Gets the NUMA placement of the buffer's mapped pages.
+		///
+		/// \return The NUMA policy.
+		[[nodiscard]] binary_io::numa_policy numa_policy() const noexcept { return this->_numa; }
+
+		/// \brief Sets the NUMA placement of the buffer's mapped pages.
+		///
+		/// \remark If the buffer is already mapped, its pages are migrated to match. The policy
+		///		is a hint, which is ignored where the platform does not support it, and has no
+		///		effect on buffers which live on the heap.
+		/// \param a_policy The new NUMA policy.
+		void numa_policy(const binary_io::numa_policy& a_policy) noexcept
+		{
+			this->_numa = a_policy;
+			if (this->_mapped) {
+				(void)binary_io::numa_bind({ this->_data, this->_capacity }, this->_numa);
+			}
+		}
+
+		/// @}
+
+		/// \name Modifiers
+		/// @{
+
+		void clear() noexcept { this->_size = 0; }
+
+		/// \brief Resizes the buffer to hold `a_count` bytes.
+		///
+		/// \remark New bytes are zeroed. The capacity grows geometrically.
+		/// \exception std::bad_alloc Thrown when the memory can not be allocated.
+		/// \param a_count The new size of the buffer.
+		void resize(size_type a_count)
+		{
+			if (a_count > this->_capacity) {
+				this->reserve(std::max(a_count, this->_capacity * 2));
+			}
+
+			if (a_count > this->_size) {
+				const auto dirty = std::min(a_count, this->_dirty);
+				if (dirty > this->_size) {
+					std::memset(this->_data + this->_size, 0, dirty - this->_size);
+				}
+				this->_dirty = std::max(this->_dirty, a_count);
+			}
+			this->_size = a_count;
+		}
+
+		/// \brief Resizes the buffer to hold `a_count` bytes, leaving new bytes uninitialized.
+		///
+		/// \remark The capacity grows geometrically.
+		/// \exception std::bad_alloc Thrown when the memory can not be allocated.
+		/// \param a_count The new size of the buffer.
+		void resize(size_type a_count, default_init_t)
+		{
+			if (a_count > this->_capacity) {
+				this->reserve(std::max(a_count, this->_capacity * 2));
+			}
+
+			this->_dirty = std::max(this->_dirty, a_count);
+			this->_size = a_count;
+		}
+
+		void swap(huge_page_buffer& a_rhs) noexcept
+		{
+			std::swap(this->_data, a_rhs._data);
+			std::swap(this->_size, a_rhs._size);
+			std::swap(this->_capacity, a_rhs._capacity);
+			std::swap(this->_dirty, a_rhs._dirty);
+			std::swap(this->_numa, a_rhs._numa);
+			std::swap(this->_mapped, a_rhs._mapped);
+		}
+
+		/// @}
+
+	private:
+		void deallocate() noexcept;
+		void place(std::span<const std::byte> a_pages) const noexcept;
+
+		std::byte* _data{ nullptr };
+		std::size_t _size{ 0 };
+		std::size_t _capacity{ 0 };
+		std::size_t _dirty{ 0 };  // every byte past this offset is known to be zero
+		binary_io::numa_policy _numa;
+		bool _mapped{ false };
+	};
+}
@@ -0,0 +1,252 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <system_error>
+#include <utility>
+
+#include "binary_io/common.hpp"
+#include "binary_io/copy_policy.hpp"
+#include "binary_io/file_stream.hpp"
+
+namespace binary_io
+{
+	/// \brief An output stream which writes into a memory mapping of a file.
+	///
+	/// \remark Writes are plain copies into the mapping, so seeking is free and randomly laid out
+	///		outputs don't pay for a buffer flush per seek. The file is grown in large increments
+	///		as it is written to, and truncated to its final size when the stream is closed.
+	/// \remark Writes are copied according to the stream's \ref copy_policy.
+	class mapped_file_ostream final :
+		public components::basic_seek_stream,
+		public components::basic_copy_stream,
+		public binary_io::ostream_interface<mapped_file_ostream>
+	{
+	public:
+		/// \brief The smallest increment the file is grown by.
+		static constexpr std::size_t growth_granularity = 1u << 20;
+
+		mapped_file_ostream() noexcept = default;
+		mapped_file_ostream(const mapped_file_ostream&) = delete;
+
+		mapped_file_ostream(mapped_file_ostream&& a_rhs) noexcept :
+			basic_seek_stream(a_rhs),
+			basic_copy_stream(a_rhs),
+			ostream_interface(a_rhs),
+			_data(std::exchange(a_rhs._data, nullptr)),
+			_size(std::exchange(a_rhs._size, 0)),
+			_capacity(std::exchange(a_rhs._capacity, 0)),
+#if BINARY_IO_OS_WINDOWS
+			_mapping(std::exchange(a_rhs._mapping, nullptr)),
+			_file(std::exchange(a_rhs._file, nullptr))
+#else
+			_file(std::exchange(a_rhs._file, -1))
+#endif
+		{}
+
+		/// \copydoc file_ostream::file_ostream()
+		mapped_file_ostream(
+			const std::filesystem::path& a_path,
+			write_mode a_mode = write_mode::truncate)
+		{
+			this->open(a_path, a_mode);
+		}
+
+		/// \copydoc open(const directory_handle&, const std::filesystem::path&, write_mode)
+		mapped_file_ostream(
+			const directory_handle& a_directory,
+			const std::filesystem::path& a_path,
+			write_mode a_mode = write_mode::truncate)
+		{
+			this->open(a_directory, a_path, a_mode);
+		}
+
+		/// \remark Errors encountered while truncating the file are only reported by an explicit
+		///		call to \ref close().
+		~mapped_file_ostream() noexcept { (void)this->release(); }
+
+		mapped_file_ostream& operator=(const mapped_file_ostream&) = delete;
+
+		mapped_file_ostream& operator=(mapped_file_ostream&& a_rhs) noexcept
+		{
+			if (this != &a_rhs) {
+				(void)this->release();
+				basic_seek_stream::operator=(a_rhs);
+				basic_copy_stream::operator=(a_rhs);
+				ostream_interface::operator=(a_rhs);
+				this->_data = std::exchange(a_rhs._data, nullptr);
+				this->_size = std::exchange(a_rhs._size, 0);
+				this->_capacity = std::exchange(a_rhs._capacity, 0);
+#if BINARY_IO_OS_WINDOWS
+				this->_mapping = std::exchange(a_rhs._mapping, nullptr);
+				this->_file = std::exchange(a_rhs._file, nullptr);
+#else
+				this->_file = std::exchange(a_rhs._file, -1);
+#endif
+			}
+			return *this;
+		}
+
+		/// \name Buffer management
+		/// @{
+
+		/// \brief Provides access to the bytes written so far.
+		///
+		/// \remark The view is invalidated when the mapping grows.
+		/// \return The bytes written so far.
+		[[nodiscard]] auto rdbuf() noexcept
+			-> std::span<std::byte> { return { this->_data, this->_size }; }
+
+		/// \copydoc rdbuf()
+		[[nodiscard]] auto rdbuf() const noexcept
+			-> std::span<const std::byte> { return { this->_data, this->_size }; }
+
+		/// \brief Gets the number of bytes the file can hold before it must be grown.
+		///
+		/// \return The capacity of the mapping.
+		[[nodiscard]] std::size_t capacity() const noexcept { return this->_capacity; }
+
+		/// \brief Gets the size the file will be truncated to when it is closed.
+		///
+		/// \return The furthest extent written to.
+		[[nodiscard]] std::size_t size() const noexcept { return this->_size; }
+
+		/// \brief Grows the mapping so that it can hold at least the given number of bytes.
+		///
+		/// \exception std::system_error Thrown when the mapping can not be grown.
+		/// \pre \ref is_open() _must_ be `true`.
+		/// \param a_capacity The number of bytes the file must be able to hold.
+		void reserve(std::size_t a_capacity);
+
+		/// @}
+
+		/// \name File operations
+		/// @{
+
+		/// \brief Opens and maps the file at the given path.
+		///
+		/// \remark When appending, the stream starts positioned at the end of the file.
+		/// \exception std::system_error Thrown when filesystem errors are encountered, or when the
+		///		path does not refer to a regular file.
+		/// \post \ref is_open() is `true`.
+		/// \param a_path The path to the file to open.
+		/// \param a_mode The mode to open the file in.
+		void open(
+			const std::filesystem::path& a_path,
+			write_mode a_mode = write_mode::truncate)
+		{
+			this->open(nullptr, a_path, a_mode);
+		}
+
+		/// \copybrief open(const std::filesystem::path&, write_mode)
+		///
+		/// \copydetails open(const std::filesystem::path&, write_mode)
+		/// \pre `a_directory.is_open()` _must_ be `true`.
+		/// \param a_directory The directory to resolve the path from.
+		void open(
+			const directory_handle& a_directory,
+			const std::filesystem::path& a_path,
+			write_mode a_mode = write_mode::truncate)
+		{
+			this->open(std::addressof(a_directory), a_path, a_mode);
+		}
+
+		/// \brief Unmaps the file, truncates it to its final size, and closes it, if applicable.
+		///
+		/// \remark The file is closed even when an error is thrown.
+		/// \exception std::system_error Thrown when the file can not be unmapped or truncated to
+		///		its final size.
+		/// \post \ref is_open() is `false`.
+		void close()
+		{
+			if (const auto error = this->release(); error) {
+				throw std::system_error{ error, "failed to close mapped file" };
+			}
+		}
+
+		/// \copydoc file_stream_base::is_open()
+		[[nodiscard]] bool is_open() const noexcept
+		{
+#if BINARY_IO_OS_WINDOWS
+			return this->_file != nullptr;
+#else
+			return this->_file != -1;
+#endif
+		}
+
+		/// @}
+
+		/// \name Writing
+		/// @{
+
+		/// \brief Provides a writable window of `a_count` bytes at the current position,
+		///		growing the file as needed.
+		///
+		/// \remark Bytes written into the window are not part of the stream until they are committed.
+		///		The window is invalidated by any other operation on the stream.
+		/// \exception std::system_error Thrown when the mapping can not be grown.
+		/// \pre \ref is_open() _must_ be `true`.
+		/// \param a_count The size of the window.
+		/// \return The writable window.
+		[[nodiscard]] auto prepare(std::size_t a_count)
+			-> std::span<std::byte>
+		{
+			const auto where = static_cast<std::size_t>(this->tell());
+			if (const auto wantsz = where + a_count; wantsz > this->_capacity) {
+				this->reserve(wantsz);
+			}
+			return { this->_data + where, a_count };
+		}
+
+		/// \brief Commits `a_count` bytes written into the window provided by \ref prepare().
+		///
+		/// \pre `a_count` _must_ be less than or equal to the size of the prepared window.
+		/// \param a_count The number of bytes to commit.
+		void commit(std::size_t a_count) noexcept
+		{
+			this->seek_relative(static_cast<binary_io::streamoff>(a_count));
+			this->_size = std::max(this->_size, static_cast<std::size_t>(this->tell()));
+			assert(this->_size <= this->_capacity);
+		}
+
+		/// \copydoc span_ostream::write_bytes
+		///
+		/// \exception std::system_error Thrown when the mapping can not be grown.
+		void write_bytes(std::span<const std::byte> a_src)
+		{
+			if (a_src.empty()) {
+				return;
+			}
+
+			const auto dst = this->prepare(a_src.size_bytes());
+			this->copy_bytes(dst, a_src);
+			this->commit(a_src.size_bytes());
+		}
+
+		/// @}
+
+	private:
+		void open(
+			const directory_handle* a_directory,
+			const std::filesystem::path& a_path,
+			write_mode a_mode);
+
+		// closes the file, returning the first error encountered along the way
+		[[nodiscard]] std::error_code release() noexcept;
+
+		[[nodiscard]] std::error_code unmap() noexcept;
+
+		std::byte* _data{ nullptr };
+		std::size_t _size{ 0 };
+		std::size_t _capacity{ 0 };
+#if BINARY_IO_OS_WINDOWS
+		void* _mapping{ nullptr };
+		void* _file{ nullptr };
+#else
+		int _file{ -1 };
+#endif
+	};
+}
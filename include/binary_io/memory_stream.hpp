@@ -1,18 +1,45 @@
 #pragma once
 
+#include <algorithm>
 #include <concepts>
 #include <cstddef>
-#include <cstring>
 #include <iterator>
 #include <span>
 #include <type_traits>
 #include <utility>
-#include <vector>
 
+#include "binary_io/byte_buffer.hpp"
 #include "binary_io/common.hpp"
+#include "binary_io/copy_policy.hpp"
 
 namespace binary_io
 {
+	/// \brief Controls when a \ref basic_memory_ostream gives memory back as it is reset.
+	///
+	/// \remark The stream tracks its recent usage, which jumps up to the size of any larger
+	///		message, and decays towards the size of smaller ones. When the capacity of the buffer
+	///		exceeds \ref factor times the recent usage, it is shrunk down to the recent usage.
+	///		This way, the footprint of a long-lived stream follows its workload rather than the
+	///		largest message it has ever seen.
+	struct trim_policy
+	{
+		/// \brief How many times larger than the recent usage the capacity may grow before it
+		///		is trimmed.
+		///
+		/// \remark A value of `0` never trims, which keeps the capacity at its peak.
+		std::size_t factor{ 0 };
+
+		/// \brief How quickly the recent usage forgets a spike.
+		///
+		/// \remark Each reset moves the recent usage `1 / decay` of the way down towards the size
+		///		of the latest message, so a spike is half forgotten after roughly `0.7 * decay`
+		///		resets. A value of `1` only remembers the latest message.
+		std::size_t decay{ 8 };
+
+		/// \brief The capacity the buffer is never trimmed below.
+		std::size_t min_capacity{ 1u << 12 };
+	};
+
 	namespace components
 	{
 		/// \brief Implements the common interface of every `memory_stream`.
@@ -46,6 +73,20 @@ namespace binary_io
 				_buffer(std::move(a_container))
 			{}
 
+			/// \brief Copies the given bytes into the underlying buffer.
+			///
+			/// \remark Lets a buffer of another type (i.e. `std::vector<std::byte>`) seed a stream
+			///		whose container only converts from it explicitly.
+			/// \param a_bytes The bytes to copy.
+			template <class Range>
+			requires(
+				!std::same_as<std::remove_cvref_t<Range>, container_type> &&
+				!std::convertible_to<const Range&, container_type> &&
+				std::constructible_from<container_type, const Range&>)
+			explicit basic_memory_stream_base(const Range& a_bytes) :
+				_buffer(a_bytes)
+			{}
+
 			/// \brief Constructs the underlying buffer, in-place, using the given args.
 			///
 			/// \param a_args The args to construct the buffer with.
@@ -83,10 +124,12 @@ namespace binary_io
 
 	/// \brief A stream which composes a dynamically sized container.
 	///
+	/// \remark Reads are copied according to the stream's \ref copy_policy.
 	/// \tparam Container The container type to use as the underlying buffer.
 	template <class Container>
 	class basic_memory_istream final :
 		public components::basic_memory_stream_base<Container>,
+		public components::basic_copy_stream,
 		public binary_io::istream_interface<basic_memory_istream<Container>>
 	{
 	private:
@@ -105,9 +148,8 @@ namespace binary_io
 				return;
 			}
 
-			const auto count = a_dst.size_bytes();
-			const auto bytes = this->read_bytes(count);
-			std::memcpy(a_dst.data(), bytes.data(), count);
+			const auto bytes = this->read_bytes(a_dst.size_bytes());
+			this->copy_bytes(a_dst, bytes);
 		}
 
 		/// \copydoc span_istream::read_bytes(std::size_t)
@@ -136,10 +178,14 @@ namespace binary_io
 		/// @}
 	};
 
-	/// \copydoc basic_memory_istream
+	/// \brief A stream which composes a dynamically sized container.
+	///
+	/// \remark Writes are copied according to the stream's \ref copy_policy.
+	/// \tparam Container The container type to use as the underlying buffer.
 	template <class Container>
 	class basic_memory_ostream final :
 		public components::basic_memory_stream_base<Container>,
+		public components::basic_copy_stream,
 		public binary_io::ostream_interface<basic_memory_ostream<Container>>
 	{
 	private:
@@ -159,29 +205,152 @@ namespace binary_io
 				return;
 			}
 
+			// the window is overwritten in full, so only the gap before it needs zeroing
+			const auto dst = this->window(a_src.size_bytes(), false);
+			this->copy_bytes(dst, a_src);
+			this->commit(a_src.size_bytes());
+		}
+
+		/// \copydoc span_ostream::prepare
+		///
+		/// \remark Resizable containers are grown to hold the whole window. The buffer is cut
+		///		back to the committed bytes by the next call to \ref commit(), so a window may be
+		///		prepared for an upper bound, and only the bytes actually encoded committed. A window
+		///		which is never committed is discarded by the next write.
+		[[nodiscard]] auto prepare(std::size_t a_count)
+			-> std::span<std::byte>
+		{
+			return this->window(a_count, true);
+		}
+
+		/// \brief Provides a window of `a_count` bytes at the current position, without zeroing
+		///		the bytes the buffer grows by.
+		///
+		/// \remark Behaves as \ref prepare(std::size_t), except that, for containers which meet
+		///		\ref binary_io::concepts::default_init_resizable, the bytes of the window past the
+		///		old end of the buffer are left uninitialized. Every byte of the window which is
+		///		committed _must_ be written first.
+		/// \param a_count The size of the window.
+		/// \return The window.
+		[[nodiscard]] auto prepare(std::size_t a_count, binary_io::default_init_t)
+			-> std::span<std::byte>
+		{
+			return this->window(a_count, false);
+		}
+
+		/// \copydoc span_ostream::commit
+		void commit(std::size_t a_count) noexcept
+		{
+			if (this->_pending) {
+				const auto where = static_cast<std::size_t>(this->tell());
+				this->truncate(std::max(this->_committed, where + a_count));
+			}
+			this->seek_relative(static_cast<binary_io::streamoff>(a_count));
+		}
+
+		/// @}
+
+		/// \name Buffer management
+		/// @{
+
+		/// \brief Gets the policy the stream trims its buffer with.
+		///
+		/// \return The trim policy.
+		[[nodiscard]] binary_io::trim_policy trim_policy() const noexcept { return this->_trimPolicy; }
+
+		/// \brief Sets the policy the stream trims its buffer with.
+		///
+		/// \param a_policy The new trim policy.
+		void trim_policy(const binary_io::trim_policy& a_policy) noexcept { this->_trimPolicy = a_policy; }
+
+		/// \brief Empties the buffer and rewinds the stream, so that it can be reused for the
+		///		next message.
+		///
+		/// \remark The capacity of the buffer is kept, unless the stream's \ref trim_policy
+		///		calls for it to be trimmed, and the container can release capacity.
+		/// \exception std::bad_alloc Thrown when a trimmed buffer can not be allocated.
+		/// \post The buffer is empty, and `tell()` is `0`.
+		void reset()
+		{
+			auto& buffer = this->rdbuf();
+			const auto used = static_cast<std::size_t>(std::size(buffer));
+			const auto decay = std::max<std::size_t>(this->_trimPolicy.decay, 1);
+			this->_recentUsage =
+				used >= this->_recentUsage ?
+					used :
+					this->_recentUsage - (this->_recentUsage - used + decay - 1) / decay;
+
+			buffer.clear();
+			this->seek_absolute(0);
+			this->_pending = false;
+
+			if constexpr (concepts::shrinkable<container_type>) {
+				const auto factor = this->_trimPolicy.factor;
+				const auto target = std::max(this->_recentUsage, this->_trimPolicy.min_capacity);
+				if (factor != 0 && buffer.capacity() / factor > target) {
+					buffer.shrink_to_fit();
+					buffer.reserve(target);
+				}
+			}
+		}
+
+		/// @}
+
+	private:
+		[[nodiscard]] auto window(std::size_t a_count, bool a_zeroed)
+			-> std::span<std::byte>
+		{
 			const auto where = this->tell();
 			assert(where >= 0);
 
+			if (this->_pending) {
+				this->truncate(this->_committed);
+			}
+
 			auto& buffer = this->rdbuf();
-			if (const auto wantsz = where + a_src.size_bytes();
-				wantsz > std::size(buffer)) {
-				if constexpr (concepts::resizable<container_type>) {
-					buffer.resize(static_cast<std::size_t>(wantsz));
+			const auto size = std::size(buffer);
+			if (const auto wantsz = static_cast<std::size_t>(where) + a_count;
+				wantsz > size) {
+				this->_committed = size;
+				this->_pending = true;
+				if constexpr (concepts::default_init_resizable<container_type>) {
+					buffer.resize(wantsz, binary_io::default_init);
+					const auto zeroed =
+						a_zeroed ?
+							wantsz :
+							std::max(size, static_cast<std::size_t>(where));
+					std::fill(std::data(buffer) + size, std::data(buffer) + zeroed, std::byte{ 0 });
+				} else if constexpr (concepts::resizable<container_type>) {
+					buffer.resize(wantsz);
 				} else {
 					throw binary_io::buffer_exhausted();
 				}
 			}
 
-			this->seek_relative(static_cast<binary_io::streamoff>(a_src.size_bytes()));
-			std::memcpy(
+			return {
 				std::data(buffer) + where,
-				a_src.data(),
-				a_src.size_bytes());
+				a_count
+			};
 		}
 
-		/// @}
+		// cuts the buffer back to the bytes committed before the outstanding window was grown
+		void truncate(std::size_t a_size) noexcept
+		{
+			this->_pending = false;
+			if constexpr (concepts::resizable<container_type>) {
+				auto& buffer = this->rdbuf();
+				if (std::size(buffer) > a_size) {
+					buffer.resize(a_size);
+				}
+			}
+		}
+
+		binary_io::trim_policy _trimPolicy;
+		std::size_t _recentUsage{ 0 };
+		std::size_t _committed{ 0 };  // the size of the buffer before the outstanding window
+		bool _pending{ false };       // whether the buffer was grown for an uncommitted window
 	};
 
-	using memory_istream = binary_io::basic_memory_istream<std::vector<std::byte>>;
-	using memory_ostream = binary_io::basic_memory_ostream<std::vector<std::byte>>;
+	using memory_istream = binary_io::basic_memory_istream<binary_io::byte_buffer>;
+	using memory_ostream = binary_io::basic_memory_ostream<binary_io::byte_buffer>;
 }
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "binary_io/common.hpp"
+
+namespace binary_io
+{
+	/// \brief Where the pages of a buffer should be placed on a NUMA system.
+	enum class numa_placement
+	{
+		/// \brief Pages are placed on the node of the thread which first touches them.
+		///
+		/// \remark Combined with \ref prefault(), this lets the thread which will consume a
+		///		buffer decide where it lives, rather than the thread which allocated it.
+		first_touch,
+
+		/// \brief Pages are spread round-robin across the nodes, so that threads on every node
+		///		see the same average latency and bandwidth.
+		interleave,
+
+		/// \brief Pages are placed on the nodes, and only the nodes, in the policy's mask.
+		bind,
+	};
+
+	/// \brief Controls where the pages of a buffer are placed on a NUMA system.
+	///
+	/// \remark Only \ref huge_page_buffer applies a policy on its own, and only to the
+	///		buffers it maps from the operating system. Other containers, such as `std::vector`
+	///		or \ref byte_buffer, are left to the allocator's placement, unless \ref numa_bind()
+	///		is called on their storage directly.
+	struct numa_policy
+	{
+		/// \brief The kind of placement.
+		numa_placement placement{ numa_placement::first_touch };
+
+		/// \brief A bitmask of the nodes to place pages on, where bit `n` selects node `n`.
+		///
+		/// \remark An empty mask selects every node which is online. Nodes numbered `64` and
+		///		above can't be selected.
+		std::uint64_t nodes{ 0 };
+	};
+
+	/// \brief Gets the number of NUMA nodes in the system.
+	///
+	/// \remark Node numbers need not be dense, since nodes may be taken offline, so this is
+	///		one more than the highest node number rather than a count of the nodes online.
+	/// \return The number of nodes, which is `1` on systems without NUMA.
+	[[nodiscard]] std::size_t numa_node_count() noexcept;
+
+	/// \brief Gets the NUMA node the calling thread is running on.
+	///
+	/// \remark Unless the thread is pinned, the answer may be stale as soon as it is returned.
+	/// \return The node of the calling thread, which is `0` on systems without NUMA.
+	[[nodiscard]] std::size_t current_numa_node() noexcept;
+
+	/// \brief Applies the given placement to the pages which overlap the given region.
+	///
+	/// \remark Pages which already exist are migrated to conform to the policy, and pages
+	///		which don't yet exist are placed according to it when they are first touched. The
+	///		region is widened to whole pages, so neighbouring data may be affected.
+	/// \remark Only supported on Linux.
+	/// \param a_region The region to place.
+	/// \param a_policy The placement to apply.
+	/// \return `true` if the policy was applied, `false` if the platform does not support it.
+	bool numa_bind(
+		std::span<const std::byte> a_region,
+		const numa_policy& a_policy) noexcept;
+
+	/// \brief Touches every page in the given region from the calling thread, by writing
+	///		each page's first byte back to itself.
+	///
+	/// \remark Under \ref numa_placement::first_touch, this places the pages which don't yet
+	///		exist on the calling thread's node.
+	/// \pre No other thread may be writing to the region.
+	/// \param a_region The region to touch.
+	void prefault(std::span<std::byte> a_region) noexcept;
+
+	/// \brief Touches every page in the given region from the calling thread, by reading
+	///		each page's first byte.
+	///
+	/// \remark Meant for read-only file mappings, such as \ref pack_reader::rdbuf(), where
+	///		reading is enough to bring the page cache onto the calling thread's node. Reading
+	///		anonymous memory which has never been written maps the shared zero page instead.
+	/// \param a_region The region to touch.
+	void prefault(std::span<const std::byte> a_region) noexcept;
+}
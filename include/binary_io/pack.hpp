@@ -0,0 +1,331 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "binary_io/common.hpp"
+#include "binary_io/span_stream.hpp"
+
+namespace binary_io
+{
+#ifndef DOXYGEN
+	namespace detail
+	{
+		struct pack_format
+		{
+			static constexpr std::uint32_t magic = 0x4B415042;  // "BPAK"
+			static constexpr std::uint32_t version = 1;
+			static constexpr std::size_t header_size = 32;
+			static constexpr std::size_t slot_size = 40;
+			static constexpr std::size_t data_alignment = 16;
+
+			[[nodiscard]] static constexpr std::uint64_t hash(std::string_view a_name) noexcept
+			{
+				std::uint64_t result = 0xCBF29CE484222325;
+				for (const auto c : a_name) {
+					result ^= static_cast<std::uint8_t>(c);
+					result *= 0x100000001B3;
+				}
+				return result;
+			}
+		};
+
+		struct pack_slot
+		{
+			std::uint64_t hash{ 0 };
+			std::uint64_t nameOffset{ 0 };
+			std::uint64_t nameSize{ 0 };
+			std::uint64_t dataOffset{ 0 };
+			std::uint64_t dataSize{ 0 };
+		};
+	}
+#endif
+
+	/// \brief Writes many named blobs into a single archive, which can be opened with
+	///		\ref pack_reader.
+	///
+	/// \remark A pack is laid out as a header, the blobs in the order they were added (each
+	///		aligned to 16 bytes), their names, and then an open addressed hash table which maps
+	///		names to blobs. Everything is written in little endian format, and every offset is
+	///		relative to the start of the pack.
+	/// \tparam Stream A stream type derived from \ref binary_io::ostream_interface.
+	template <class Stream>
+	class pack_writer
+	{
+	public:
+		using stream_type = Stream;
+
+		/// \brief Begins a pack by writing a placeholder header.
+		///
+		/// \param a_out The stream to write the pack into. It _must_ outlive the writer.
+		pack_writer(stream_type& a_out) :
+			_out(std::addressof(a_out)),
+			_start(a_out.tell())
+		{
+			static_assert(concepts::output_stream<stream_type>);
+			this->write_header(0, 0, 0);
+		}
+
+		pack_writer(const pack_writer&) = delete;
+		pack_writer& operator=(const pack_writer&) = delete;
+
+		/// \brief Appends a blob to the pack.
+		///
+		/// \param a_name The name the blob will be looked up by.
+		/// \param a_bytes The contents of the blob.
+		void add(std::string_view a_name, std::span<const std::byte> a_bytes)
+		{
+			this->align(format::data_alignment);
+			this->_entries.push_back(entry{
+				std::string(a_name),
+				this->offset(),
+				a_bytes.size_bytes() });
+			this->_out->write_bytes(a_bytes);
+		}
+
+		/// \brief Ends the pack by writing its index and filling in its header.
+		///
+		/// \remark The stream is left positioned at the end of the pack.
+		/// \exception binary_io::exception Thrown when two blobs were added with the same name.
+		void finish()
+		{
+			std::vector<detail::pack_slot> slots;
+			slots.reserve(this->_entries.size());
+			for (const auto& entry : this->_entries) {
+				slots.push_back(detail::pack_slot{
+					format::hash(entry.name),
+					this->offset(),
+					entry.name.size(),
+					entry.offset,
+					entry.size });
+				this->_out->write_bytes(std::as_bytes(std::span{ entry.name }));
+			}
+
+			const std::size_t tableSize =
+				slots.empty() ? 0 : std::bit_ceil(slots.size() * 2);
+			std::vector<std::size_t> table(tableSize, slots.size());
+			for (std::size_t i = 0; i < slots.size(); ++i) {
+				auto pos = static_cast<std::size_t>(slots[i].hash) & (tableSize - 1);
+				for (; table[pos] != slots.size(); pos = (pos + 1) & (tableSize - 1)) {
+					const auto j = table[pos];
+					if (slots[j].hash == slots[i].hash &&
+						this->_entries[j].name == this->_entries[i].name) {
+						throw binary_io::exception("duplicate name in pack");
+					}
+				}
+				table[pos] = i;
+			}
+
+			this->align(8);
+			const auto indexOffset = this->offset();
+			for (const auto i : table) {
+				const auto slot = i != slots.size() ? slots[i] : detail::pack_slot{};
+				this->_out->write(
+					std::endian::little,
+					slot.hash,
+					slot.nameOffset,
+					slot.nameSize,
+					slot.dataOffset,
+					slot.dataSize);
+			}
+
+			const auto end = this->_out->tell();
+			this->_out->seek_absolute(this->_start);
+			this->write_header(slots.size(), tableSize, indexOffset);
+			this->_out->seek_absolute(end);
+		}
+
+	private:
+		using format = detail::pack_format;
+
+		struct entry
+		{
+			std::string name;
+			std::uint64_t offset{ 0 };
+			std::uint64_t size{ 0 };
+		};
+
+		[[nodiscard]] std::uint64_t offset() const
+		{
+			return static_cast<std::uint64_t>(this->_out->tell() - this->_start);
+		}
+
+		void align(std::size_t a_alignment)
+		{
+			static constexpr std::array<std::byte, format::data_alignment> padding{};
+			const auto misalignment = static_cast<std::size_t>(this->offset() % a_alignment);
+			if (misalignment != 0) {
+				this->_out->write_bytes(std::span{ padding }.first(a_alignment - misalignment));
+			}
+		}
+
+		void write_header(
+			std::uint64_t a_entryCount,
+			std::uint64_t a_tableSize,
+			std::uint64_t a_indexOffset)
+		{
+			this->_out->write(
+				std::endian::little,
+				format::magic,
+				format::version,
+				a_entryCount,
+				a_tableSize,
+				a_indexOffset);
+		}
+
+		stream_type* _out{ nullptr };
+		binary_io::streamoff _start{ 0 };
+		std::vector<entry> _entries;
+	};
+
+	/// \brief Maps a pack written by \ref pack_writer into memory, and hands out views of the
+	///		blobs inside it.
+	///
+	/// \remark The whole pack is mapped once when it is opened, so finding a blob is a hash
+	///		lookup rather than a file open. The views handed out are invalidated when the reader
+	///		is closed.
+	class pack_reader
+	{
+	public:
+		pack_reader() noexcept = default;
+		pack_reader(const pack_reader&) = delete;
+
+		pack_reader(pack_reader&& a_rhs) noexcept :
+			_data(std::exchange(a_rhs._data, nullptr)),
+			_size(std::exchange(a_rhs._size, 0)),
+			_entryCount(std::exchange(a_rhs._entryCount, 0)),
+			_tableSize(std::exchange(a_rhs._tableSize, 0)),
+			_indexOffset(std::exchange(a_rhs._indexOffset, 0))
+#if BINARY_IO_OS_WINDOWS
+			,
+			_mapping(std::exchange(a_rhs._mapping, nullptr))
+#endif
+		{}
+
+		/// \copydoc open()
+		explicit pack_reader(const std::filesystem::path& a_path) { this->open(a_path); }
+
+		~pack_reader() noexcept { this->close(); }
+
+		pack_reader& operator=(const pack_reader&) = delete;
+
+		pack_reader& operator=(pack_reader&& a_rhs) noexcept
+		{
+			if (this != &a_rhs) {
+				this->close();
+				this->_data = std::exchange(a_rhs._data, nullptr);
+				this->_size = std::exchange(a_rhs._size, 0);
+				this->_entryCount = std::exchange(a_rhs._entryCount, 0);
+				this->_tableSize = std::exchange(a_rhs._tableSize, 0);
+				this->_indexOffset = std::exchange(a_rhs._indexOffset, 0);
+#if BINARY_IO_OS_WINDOWS
+				this->_mapping = std::exchange(a_rhs._mapping, nullptr);
+#endif
+			}
+			return *this;
+		}
+
+		/// \name Buffer management
+		/// @{
+
+		/// \brief Provides access to the whole of the mapped pack.
+		///
+		/// \return The mapped pack.
+		[[nodiscard]] auto rdbuf() const noexcept
+			-> std::span<const std::byte> { return { this->_data, this->_size }; }
+
+		/// \brief Gets the number of blobs in the pack.
+		///
+		/// \return The number of blobs in the pack.
+		[[nodiscard]] std::size_t size() const noexcept { return this->_entryCount; }
+
+		/// @}
+
+		/// \name File operations
+		/// @{
+
+		/// \brief Opens and maps the pack at the given path.
+		///
+		/// \remark The index is validated up front, so lookups never read outside the mapping.
+		/// \exception std::system_error Thrown when filesystem errors are encountered.
+		/// \exception binary_io::exception Thrown when the file is not a valid pack.
+		/// \post \ref is_open() is `true`.
+		/// \param a_path The path to the pack to open.
+		void open(const std::filesystem::path& a_path);
+
+		/// \brief Unmaps the pack, if applicable.
+		///
+		/// \post \ref is_open() is `false`.
+		void close() noexcept;
+
+		/// \copydoc file_stream_base::is_open()
+		[[nodiscard]] bool is_open() const noexcept { return this->_data != nullptr; }
+
+		/// @}
+
+		/// \name Lookup
+		/// @{
+
+		/// \brief Checks if the pack contains a blob with the given name.
+		///
+		/// \param a_name The name of the blob.
+		/// \return `true` if the blob exists, `false` otherwise.
+		[[nodiscard]] bool contains(std::string_view a_name) const noexcept
+		{
+			return this->lookup(a_name).has_value();
+		}
+
+		/// \brief Finds the blob with the given name.
+		///
+		/// \param a_name The name of the blob.
+		/// \return A stream over the blob, or `std::nullopt` if there is none.
+		[[nodiscard]] std::optional<span_istream> find(std::string_view a_name) const noexcept
+		{
+			const auto bytes = this->lookup(a_name);
+			return bytes ? std::optional<span_istream>{ std::in_place, *bytes } : std::nullopt;
+		}
+
+		/// \brief Gets the blob with the given name.
+		///
+		/// \exception binary_io::exception Thrown when there is no blob with the given name.
+		/// \param a_name The name of the blob.
+		/// \return A stream over the blob.
+		[[nodiscard]] span_istream at(std::string_view a_name) const
+		{
+			const auto bytes = this->lookup(a_name);
+			if (!bytes) {
+				throw binary_io::exception("name not found in pack");
+			}
+			return span_istream{ *bytes };
+		}
+
+		/// @}
+
+	private:
+		using format = detail::pack_format;
+
+		[[nodiscard]] auto lookup(std::string_view a_name) const noexcept
+			-> std::optional<std::span<const std::byte>>;
+
+		[[nodiscard]] detail::pack_slot slot(std::size_t a_index) const noexcept;
+
+		const std::byte* _data{ nullptr };
+		std::size_t _size{ 0 };
+		std::size_t _entryCount{ 0 };
+		std::size_t _tableSize{ 0 };
+		std::size_t _indexOffset{ 0 };
+#if BINARY_IO_OS_WINDOWS
+		void* _mapping{ nullptr };
+#endif
+	};
+}
@@ -0,0 +1,276 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <utility>
+
+#include "binary_io/common.hpp"
+
+namespace binary_io
+{
+	class file_istream;
+	class file_ostream;
+	class pipe_istream;
+	class pipe_ostream;
+
+	void copy(pipe_istream& a_in, file_ostream& a_out, std::size_t a_count);
+	void copy(file_istream& a_in, pipe_ostream& a_out, std::size_t a_count);
+
+	namespace components
+	{
+		/// \brief Implements the common interface of every `pipe_stream`.
+		class pipe_stream_base
+		{
+		public:
+			/// \brief The size of the internal buffer, when none is given.
+			static constexpr std::size_t default_buffer_size = 1u << 16;
+
+			pipe_stream_base() noexcept = default;
+			pipe_stream_base(const pipe_stream_base&) = delete;
+
+			pipe_stream_base(pipe_stream_base&& a_rhs) noexcept :
+				_buffer(std::move(a_rhs._buffer)),
+				_capacity(std::exchange(a_rhs._capacity, 0)),
+				_pos(std::exchange(a_rhs._pos, 0)),
+				_fd(std::exchange(a_rhs._fd, -1))
+			{}
+
+			/// \brief Takes ownership of the given file descriptor.
+			///
+			/// \param a_fd The file descriptor of a pipe, socket, terminal, or any other byte stream.
+			/// \param a_bufferSize The size of the internal buffer.
+			pipe_stream_base(int a_fd, std::size_t a_bufferSize) :
+				_buffer(new std::byte[a_bufferSize != 0 ? a_bufferSize : 1]),
+				_capacity(a_bufferSize != 0 ? a_bufferSize : 1),
+				_fd(a_fd)
+			{}
+
+			~pipe_stream_base() noexcept { this->close(); }
+
+			pipe_stream_base& operator=(const pipe_stream_base&) = delete;
+
+			pipe_stream_base& operator=(pipe_stream_base&& a_rhs) noexcept
+			{
+				if (this != &a_rhs) {
+					this->close();
+					this->_buffer = std::move(a_rhs._buffer);
+					this->_capacity = std::exchange(a_rhs._capacity, 0);
+					this->_pos = std::exchange(a_rhs._pos, 0);
+					this->_fd = std::exchange(a_rhs._fd, -1);
+				}
+				return *this;
+			}
+
+			/// \name File operations
+			/// @{
+
+			/// \copydoc binary_io::components::file_stream_base::is_open()
+			[[nodiscard]] bool is_open() const noexcept { return this->_fd != -1; }
+
+			/// \brief Closes the stream's file descriptor, if applicable.
+			///
+			/// \post \ref is_open() is `false`.
+			void close() noexcept;
+
+			/// \brief Gets the underlying file descriptor.
+			///
+			/// \return The underlying file descriptor, or `-1` if there is none.
+			[[nodiscard]] int native_handle() const noexcept { return this->_fd; }
+
+			/// \brief Gives up ownership of the underlying file descriptor, without closing it.
+			///
+			/// \remark Any buffered bytes are discarded.
+			/// \post \ref is_open() is `false`.
+			/// \return The underlying file descriptor, or `-1` if there is none.
+			[[nodiscard]] int release() noexcept { return std::exchange(this->_fd, -1); }
+
+			/// @}
+
+			/// \name Position
+			/// @{
+
+			/// \brief Gets the number of bytes which have passed through the stream.
+			///
+			/// \return The current stream position.
+			[[nodiscard]] binary_io::streamoff tell() const noexcept { return this->_pos; }
+
+			/// @}
+
+		protected:
+			std::unique_ptr<std::byte[]> _buffer;
+			std::size_t _capacity{ 0 };
+			binary_io::streamoff _pos{ 0 };
+
+		private:
+			int _fd{ -1 };
+		};
+	}
+
+	/// \brief A buffered stream which reads from a non-seekable file descriptor, such as a pipe,
+	///		a socket, or standard input.
+	///
+	/// \remark The stream meets the requirements of
+	///		\ref binary_io::concepts::sequential_input_stream, but _not_ those of
+	///		\ref binary_io::concepts::input_stream. Data is parsed as it arrives, using no more
+	///		memory than the internal buffer.
+	/// \remark On Windows, only C runtime file descriptors are supported, which excludes sockets.
+	class pipe_istream final :
+		public components::pipe_stream_base,
+		public binary_io::istream_interface<pipe_istream>
+	{
+	private:
+		using super = components::pipe_stream_base;
+
+	public:
+		pipe_istream() noexcept = default;
+		pipe_istream(const pipe_istream&) = delete;
+
+		pipe_istream(pipe_istream&& a_rhs) noexcept :
+			super(std::move(a_rhs)),
+			istream_interface(a_rhs),
+			_first(std::exchange(a_rhs._first, 0)),
+			_last(std::exchange(a_rhs._last, 0))
+		{}
+
+		/// \copydoc binary_io::components::pipe_stream_base::pipe_stream_base(int, std::size_t)
+		explicit pipe_istream(int a_fd, std::size_t a_bufferSize = default_buffer_size) :
+			super(a_fd, a_bufferSize)
+		{}
+
+		pipe_istream& operator=(const pipe_istream&) = delete;
+
+		pipe_istream& operator=(pipe_istream&& a_rhs) noexcept
+		{
+			if (this != &a_rhs) {
+				super::operator=(std::move(a_rhs));
+				istream_interface::operator=(a_rhs);
+				this->_first = std::exchange(a_rhs._first, 0);
+				this->_last = std::exchange(a_rhs._last, 0);
+			}
+			return *this;
+		}
+
+		/// \name Reading
+		/// @{
+
+		/// \brief Checks if the writer has closed its end and every byte has been read.
+		///
+		/// \remark Blocks until at least one byte is available, or the writer closes its end.
+		/// \exception std::system_error Thrown when the file descriptor can not be read from.
+		/// \pre \ref is_open() _must_ be `true`.
+		/// \return `true` if there is nothing left to read, `false` otherwise.
+		[[nodiscard]] bool at_end();
+
+		/// \brief Reads bytes into the given buffer, blocking until they have all arrived.
+		///
+		/// \exception binary_io::buffer_exhausted Thrown when the writer closes its end before
+		///		the requested number of bytes have arrived. Those which did arrive are consumed.
+		/// \exception std::system_error Thrown when the file descriptor can not be read from.
+		/// \pre \ref is_open() _must_ be `true`.
+		/// \param a_dst The buffer to read bytes into.
+		void read_bytes(std::span<std::byte> a_dst);
+
+		/// @}
+
+	private:
+		friend void binary_io::copy(pipe_istream&, file_ostream&, std::size_t);
+
+		[[nodiscard]] std::size_t fill(std::span<std::byte> a_dst);
+
+		std::size_t _first{ 0 };
+		std::size_t _last{ 0 };
+	};
+
+	/// \brief A buffered stream which writes to a non-seekable file descriptor, such as a pipe,
+	///		a socket, or standard output.
+	///
+	/// \remark The stream meets the requirements of
+	///		\ref binary_io::concepts::sequential_output_stream, but _not_ those of
+	///		\ref binary_io::concepts::output_stream.
+	/// \remark Writing to a socket whose peer has closed its end throws `std::system_error`
+	///		with `EPIPE`. Writing to a pipe whose reader has closed its end raises `SIGPIPE`
+	///		instead, which terminates the process by default. Processes which write to pipes
+	///		they don't control should ignore `SIGPIPE`, which turns it into the same error.
+	/// \remark On Windows, only C runtime file descriptors are supported, which excludes sockets.
+	class pipe_ostream final :
+		public components::pipe_stream_base,
+		public binary_io::ostream_interface<pipe_ostream>
+	{
+	private:
+		using super = components::pipe_stream_base;
+
+	public:
+		pipe_ostream() noexcept = default;
+		pipe_ostream(const pipe_ostream&) = delete;
+
+		pipe_ostream(pipe_ostream&& a_rhs) noexcept :
+			super(std::move(a_rhs)),
+			ostream_interface(a_rhs),
+			_size(std::exchange(a_rhs._size, 0)),
+			_socket(std::exchange(a_rhs._socket, true))
+		{}
+
+		/// \copydoc binary_io::components::pipe_stream_base::pipe_stream_base(int, std::size_t)
+		explicit pipe_ostream(int a_fd, std::size_t a_bufferSize = default_buffer_size) :
+			super(a_fd, a_bufferSize)
+		{}
+
+		~pipe_ostream() noexcept { this->close(); }
+
+		pipe_ostream& operator=(const pipe_ostream&) = delete;
+
+		pipe_ostream& operator=(pipe_ostream&& a_rhs) noexcept
+		{
+			if (this != &a_rhs) {
+				this->close();
+				super::operator=(std::move(a_rhs));
+				ostream_interface::operator=(a_rhs);
+				this->_size = std::exchange(a_rhs._size, 0);
+				this->_socket = std::exchange(a_rhs._socket, true);
+			}
+			return *this;
+		}
+
+		/// \name Buffering
+		/// @{
+
+		/// \brief Writes out every buffered byte, blocking until the reader has accepted them.
+		///
+		/// \exception std::system_error Thrown when the file descriptor can not be written to.
+		void flush();
+
+		/// @}
+
+		/// \name File operations
+		/// @{
+
+		/// \brief Flushes the buffer and closes the stream's file descriptor, if applicable.
+		///
+		/// \remark Errors encountered while flushing are ignored.
+		/// \post \ref is_open() is `false`.
+		void close() noexcept;
+
+		/// @}
+
+		/// \name Writing
+		/// @{
+
+		/// \brief Writes bytes from the given buffer.
+		///
+		/// \remark Small writes are gathered in the internal buffer, while large ones are written
+		///		straight to the file descriptor.
+		/// \exception std::system_error Thrown when the file descriptor can not be written to.
+		/// \pre \ref is_open() _must_ be `true`.
+		/// \param a_src The buffer to write bytes from.
+		void write_bytes(std::span<const std::byte> a_src);
+
+		/// @}
+
+	private:
+		friend void binary_io::copy(file_istream&, pipe_ostream&, std::size_t);
+
+		std::size_t _size{ 0 };
+		bool _socket{ true };  // until a send reports otherwise
+	};
+}
@@ -0,0 +1,390 @@
+#pragma once
+
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <tuple>
+#include <utility>
+
+#include "binary_io/common.hpp"
+#include "binary_io/span_stream.hpp"
+
+namespace binary_io
+{
+	/// \brief A non-owning view of a single record, whose fields are only decoded when accessed.
+	class record_view
+	{
+	public:
+		/// \brief Constructs an empty record.
+		record_view() noexcept = default;
+
+		/// \brief Constructs a record over the given bytes.
+		///
+		/// \param a_bytes The bytes which make up the record.
+		/// \param a_endian The endian format the record's fields are stored in.
+		record_view(
+			std::span<const std::byte> a_bytes,
+			std::endian a_endian = std::endian::native) noexcept :
+			_bytes(a_bytes),
+			_endian(a_endian)
+		{}
+
+		/// \name Observers
+		/// @{
+
+		/// \brief Gets the raw bytes of the record.
+		///
+		/// \return The bytes which make up the record.
+		[[nodiscard]] auto bytes() const noexcept
+			-> std::span<const std::byte> { return this->_bytes; }
+
+		/// \brief Gets the endian format the record's fields are decoded with.
+		///
+		/// \return The endian format of the record.
+		[[nodiscard]] std::endian endian() const noexcept { return this->_endian; }
+
+		/// \brief Gets the size of the record, in bytes.
+		///
+		/// \return The size of the record.
+		[[nodiscard]] std::size_t size() const noexcept { return this->_bytes.size(); }
+
+		/// \brief Creates an input stream over the record, for sequential decoding.
+		///
+		/// \return A stream over the bytes of the record.
+		[[nodiscard]] binary_io::span_istream stream() const noexcept
+		{
+			binary_io::span_istream result{ this->_bytes };
+			result.endian(this->_endian);
+			return result;
+		}
+
+		/// @}
+
+		/// \name Reading
+		/// @{
+
+		/// \brief Decodes the field at the given offset within the record.
+		///
+		/// \exception binary_io::buffer_exhausted Thrown when the field lies outside the record.
+		/// \tparam T The type of the field.
+		/// \param a_offset The offset of the field, relative to the start of the record.
+		/// \return The decoded field.
+		template <class T>
+		[[nodiscard]] T get(std::size_t a_offset) const
+		{
+			static_assert(concepts::integral<T>);
+			return binary_io::read<T>(this->field<sizeof(T)>(a_offset), this->_endian);
+		}
+
+		/// \brief Batch decodes the contiguous fields starting at the given offset within the record.
+		///
+		/// \exception binary_io::buffer_exhausted Thrown when the fields lie outside the record.
+		/// \tparam Args The types of the fields.
+		/// \param a_offset The offset of the first field, relative to the start of the record.
+		/// \return The decoded fields.
+		template <class... Args>
+		[[nodiscard]] std::tuple<Args...> read(std::size_t a_offset) const
+		{
+			static_assert((concepts::integral<Args> && ...));
+			constexpr auto size = (sizeof(Args) + ...);
+			return this->do_read<Args...>(
+				this->field<size>(a_offset),
+				std::index_sequence_for<Args...>{});
+		}
+
+		/// @}
+
+	private:
+		template <std::size_t N>
+		[[nodiscard]] auto field(std::size_t a_offset) const
+			-> std::span<const std::byte, N>
+		{
+			if (a_offset > this->_bytes.size() || this->_bytes.size() - a_offset < N) {
+				throw binary_io::buffer_exhausted();
+			}
+
+			return this->_bytes.subspan(a_offset).template subspan<0, N>();
+		}
+
+		template <class... Args, std::size_t... I>
+		[[nodiscard]] std::tuple<Args...> do_read(
+			std::span<const std::byte> a_bytes,
+			std::index_sequence<I...>) const
+		{
+			std::tuple<Args...> values;
+			std::size_t offset = 0;
+			((std::get<I>(values) = binary_io::read<Args>(
+				  a_bytes.subspan(offset, sizeof(Args)).template subspan<0, sizeof(Args)>(),
+				  this->_endian),
+				 offset += sizeof(Args)),
+				...);
+			return values;
+		}
+
+		std::span<const std::byte> _bytes;
+		std::endian _endian{ std::endian::native };
+	};
+
+	/// \brief A random access range of fixed-size records.
+	///
+	/// \remark Records are not decoded until their fields are accessed through
+	///		\ref binary_io::record_view.
+	class fixed_record_range :
+		public std::ranges::view_interface<fixed_record_range>
+	{
+	public:
+		class iterator
+		{
+		public:
+			using value_type = binary_io::record_view;
+			using difference_type = std::ptrdiff_t;
+			using reference = binary_io::record_view;
+			using iterator_concept = std::random_access_iterator_tag;
+
+			iterator() noexcept = default;
+
+			iterator(
+				const std::byte* a_pos,
+				std::size_t a_recordSize,
+				std::endian a_endian) noexcept :
+				_pos(a_pos),
+				_recordSize(static_cast<difference_type>(a_recordSize)),
+				_endian(a_endian)
+			{}
+
+			[[nodiscard]] reference operator*() const noexcept
+			{
+				return { { this->_pos, static_cast<std::size_t>(this->_recordSize) }, this->_endian };
+			}
+
+			[[nodiscard]] reference operator[](difference_type a_idx) const noexcept { return *(*this + a_idx); }
+
+			iterator& operator++() noexcept { return *this += 1; }
+			iterator operator++(int) noexcept { return std::exchange(*this, *this + 1); }
+			iterator& operator--() noexcept { return *this -= 1; }
+			iterator operator--(int) noexcept { return std::exchange(*this, *this - 1); }
+
+			iterator& operator+=(difference_type a_off) noexcept
+			{
+				this->_pos += a_off * this->_recordSize;
+				return *this;
+			}
+
+			iterator& operator-=(difference_type a_off) noexcept { return *this += -a_off; }
+
+			[[nodiscard]] friend iterator operator+(iterator a_lhs, difference_type a_rhs) noexcept { return a_lhs += a_rhs; }
+			[[nodiscard]] friend iterator operator+(difference_type a_lhs, iterator a_rhs) noexcept { return a_rhs += a_lhs; }
+			[[nodiscard]] friend iterator operator-(iterator a_lhs, difference_type a_rhs) noexcept { return a_lhs -= a_rhs; }
+
+			[[nodiscard]] friend difference_type operator-(const iterator& a_lhs, const iterator& a_rhs) noexcept
+			{
+				return a_lhs._recordSize != 0 ? (a_lhs._pos - a_rhs._pos) / a_lhs._recordSize : 0;
+			}
+
+			[[nodiscard]] friend bool operator==(const iterator& a_lhs, const iterator& a_rhs) noexcept { return a_lhs._pos == a_rhs._pos; }
+			[[nodiscard]] friend auto operator<=>(const iterator& a_lhs, const iterator& a_rhs) noexcept { return a_lhs._pos <=> a_rhs._pos; }
+
+		private:
+			const std::byte* _pos{ nullptr };
+			difference_type _recordSize{ 0 };
+			std::endian _endian{ std::endian::native };
+		};
+
+		/// \brief Constructs an empty range.
+		fixed_record_range() noexcept = default;
+
+		/// \brief Constructs a range over the given bytes.
+		///
+		/// \remark Trailing bytes which do not form a whole record are ignored.
+		/// \pre `a_recordSize` _must_ be greater than `0`.
+		/// \param a_bytes The bytes to partition into records.
+		/// \param a_recordSize The size of a single record, in bytes.
+		/// \param a_endian The endian format the records' fields are stored in.
+		fixed_record_range(
+			std::span<const std::byte> a_bytes,
+			std::size_t a_recordSize,
+			std::endian a_endian = std::endian::native) noexcept :
+			_bytes(whole_records(a_bytes, a_recordSize)),
+			_recordSize(a_recordSize),
+			_endian(a_endian)
+		{}
+
+		/// \brief Consumes `a_count` records from the given stream, without making a copy.
+		///
+		/// \exception binary_io::buffer_exhausted Thrown when the stream has less than the
+		///		requested number of records, including when their total size overflows.
+		/// \pre `a_recordSize` _must_ be greater than `0`.
+		/// \param a_in The stream to consume records from. Records inherit its endian format.
+		/// \param a_recordSize The size of a single record, in bytes.
+		/// \param a_count The number of records to consume.
+		fixed_record_range(
+			binary_io::span_istream& a_in,
+			std::size_t a_recordSize,
+			std::size_t a_count) :
+			fixed_record_range(a_in.read_bytes(total_size(a_recordSize, a_count)), a_recordSize, a_in.endian())
+		{}
+
+		[[nodiscard]] iterator begin() const noexcept { return { this->_bytes.data(), this->_recordSize, this->_endian }; }
+		[[nodiscard]] iterator end() const noexcept { return { this->_bytes.data() + this->_bytes.size(), this->_recordSize, this->_endian }; }
+
+		/// \brief Gets the size of a single record, in bytes.
+		///
+		/// \return The size of a single record.
+		[[nodiscard]] std::size_t record_size() const noexcept { return this->_recordSize; }
+
+	private:
+		[[nodiscard]] static std::span<const std::byte> whole_records(
+			std::span<const std::byte> a_bytes,
+			std::size_t a_recordSize) noexcept
+		{
+			assert(a_recordSize > 0);
+			return a_recordSize > 0 ?
+			           a_bytes.first(a_bytes.size() - a_bytes.size() % a_recordSize) :
+			           std::span<const std::byte>{};
+		}
+
+		[[nodiscard]] static std::size_t total_size(
+			std::size_t a_recordSize,
+			std::size_t a_count)
+		{
+			assert(a_recordSize > 0);
+			if (a_recordSize != 0 && a_count > std::numeric_limits<std::size_t>::max() / a_recordSize) {
+				throw binary_io::buffer_exhausted();
+			}
+			return a_recordSize * a_count;
+		}
+
+		std::span<const std::byte> _bytes;
+		std::size_t _recordSize{ 1 };
+		std::endian _endian{ std::endian::native };
+	};
+
+	/// \brief A forward range of records, each of which is preceded by its length.
+	///
+	/// \remark Records are not decoded until their fields are accessed through
+	///		\ref binary_io::record_view. Walking the range only decodes the length prefixes.
+	/// \tparam Length The type of the length prefix. The prefix is not included in the record.
+	template <class Length>
+	class prefixed_record_range :
+		public std::ranges::view_interface<prefixed_record_range<Length>>
+	{
+	public:
+		static_assert(concepts::integral<Length>);
+
+		class iterator
+		{
+		public:
+			using value_type = binary_io::record_view;
+			using difference_type = std::ptrdiff_t;
+			using reference = const binary_io::record_view&;
+			using iterator_concept = std::forward_iterator_tag;
+
+			iterator() noexcept = default;
+
+			iterator(
+				std::span<const std::byte> a_bytes,
+				std::endian a_endian) :
+				_rest(a_bytes),
+				_endian(a_endian)
+			{
+				this->next();
+			}
+
+			[[nodiscard]] reference operator*() const noexcept { return this->_current; }
+			[[nodiscard]] const binary_io::record_view* operator->() const noexcept { return &this->_current; }
+
+			iterator& operator++()
+			{
+				this->next();
+				return *this;
+			}
+
+			iterator operator++(int)
+			{
+				auto tmp = *this;
+				++*this;
+				return tmp;
+			}
+
+			[[nodiscard]] friend bool operator==(const iterator& a_lhs, const iterator& a_rhs) noexcept
+			{
+				return a_lhs._done == a_rhs._done &&
+				       a_lhs._rest.data() == a_rhs._rest.data();
+			}
+
+			[[nodiscard]] friend bool operator==(const iterator& a_lhs, std::default_sentinel_t) noexcept { return a_lhs._done; }
+
+		private:
+			void next()
+			{
+				if (this->_rest.empty()) {
+					this->_current = {};
+					this->_done = true;
+					return;
+				}
+
+				if (this->_rest.size() < sizeof(Length)) {
+					throw binary_io::buffer_exhausted();
+				}
+
+				const auto length = static_cast<std::size_t>(
+					binary_io::read<Length>(
+						this->_rest.template first<sizeof(Length)>(),
+						this->_endian));
+				this->_rest = this->_rest.subspan(sizeof(Length));
+				if (length > this->_rest.size()) {
+					throw binary_io::buffer_exhausted();
+				}
+
+				this->_current = { this->_rest.first(length), this->_endian };
+				this->_rest = this->_rest.subspan(length);
+				this->_done = false;
+			}
+
+			binary_io::record_view _current;
+			std::span<const std::byte> _rest;
+			std::endian _endian{ std::endian::native };
+			bool _done{ true };
+		};
+
+		/// \brief Constructs an empty range.
+		prefixed_record_range() noexcept = default;
+
+		/// \brief Constructs a range over the given bytes.
+		///
+		/// \param a_bytes The bytes to partition into records.
+		/// \param a_endian The endian format the length prefixes and the records' fields are stored in.
+		prefixed_record_range(
+			std::span<const std::byte> a_bytes,
+			std::endian a_endian = std::endian::native) noexcept :
+			_bytes(a_bytes),
+			_endian(a_endian)
+		{}
+
+		/// \brief Consumes the remainder of the given stream as records, without making a copy.
+		///
+		/// \param a_in The stream to consume records from. Records inherit its endian format.
+		explicit prefixed_record_range(binary_io::span_istream& a_in) :
+			prefixed_record_range(remainder(a_in), a_in.endian())
+		{}
+
+		/// \exception binary_io::buffer_exhausted Thrown when the first record is truncated.
+		[[nodiscard]] iterator begin() const { return { this->_bytes, this->_endian }; }
+		[[nodiscard]] std::default_sentinel_t end() const noexcept { return std::default_sentinel; }
+
+	private:
+		[[nodiscard]] static auto remainder(binary_io::span_istream& a_in)
+			-> std::span<const std::byte>
+		{
+			const auto size = static_cast<binary_io::streamoff>(a_in.rdbuf().size_bytes());
+			return a_in.read_bytes(static_cast<std::size_t>(std::max<binary_io::streamoff>(size - a_in.tell(), 0)));
+		}
+
+		std::span<const std::byte> _bytes;
+		std::endian _endian{ std::endian::native };
+	};
+}
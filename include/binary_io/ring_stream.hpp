@@ -0,0 +1,271 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <utility>
+
+#include "binary_io/common.hpp"
+
+#if BINARY_IO_OS_LINUX
+namespace binary_io
+{
+	namespace components
+	{
+		/// \brief Implements the common interface of every `ring_stream`.
+		class ring_stream_base
+		{
+		public:
+			ring_stream_base() noexcept = default;
+			ring_stream_base(const ring_stream_base&) = delete;
+
+			ring_stream_base(ring_stream_base&& a_rhs) noexcept :
+				_control(std::exchange(a_rhs._control, nullptr)),
+				_data(std::exchange(a_rhs._data, nullptr)),
+				_capacity(std::exchange(a_rhs._capacity, 0)),
+				_fd(std::exchange(a_rhs._fd, -1))
+			{}
+
+			~ring_stream_base() noexcept { this->close(); }
+
+			ring_stream_base& operator=(const ring_stream_base&) = delete;
+
+			ring_stream_base& operator=(ring_stream_base&& a_rhs) noexcept
+			{
+				if (this != &a_rhs) {
+					this->close();
+					this->_control = std::exchange(a_rhs._control, nullptr);
+					this->_data = std::exchange(a_rhs._data, nullptr);
+					this->_capacity = std::exchange(a_rhs._capacity, 0);
+					this->_fd = std::exchange(a_rhs._fd, -1);
+				}
+				return *this;
+			}
+
+			/// \name Buffer management
+			/// @{
+
+			/// \brief Gets the number of bytes the ring can hold.
+			///
+			/// \return The capacity of the ring.
+			[[nodiscard]] std::size_t capacity() const noexcept { return this->_capacity; }
+
+			/// @}
+
+			/// \name File operations
+			/// @{
+
+			/// \brief Creates a new ring in anonymous shared memory.
+			///
+			/// \remark The other end of the ring is attached by passing \ref native_handle() to
+			///		\ref open(), after it has been shared with the other process (i.e. inherited
+			///		across `fork`, or sent over a unix socket).
+			/// \exception std::system_error Thrown when the shared memory can not be created.
+			/// \post \ref is_open() is `true`.
+			/// \param a_capacity The minimum number of bytes the ring must hold. It is rounded up
+			///		to a multiple of the page size.
+			void create(std::size_t a_capacity);
+
+			/// \brief Attaches to a ring created by the other end.
+			///
+			/// \remark The ring's control page is checked for the signature and layout version
+			///		stamped by \ref create(), so arbitrary memory is never used as the ring's state.
+			/// \exception std::system_error Thrown when the file descriptor does not refer to a ring,
+			///		or refers to one with an incompatible layout. The file descriptor is closed.
+			/// \post \ref is_open() is `true`.
+			/// \param a_fd The file descriptor of the ring. The stream takes ownership of it.
+			void open(int a_fd);
+
+			/// \brief Detaches from the ring, if applicable.
+			///
+			/// \post \ref is_open() is `false`.
+			void close() noexcept;
+
+			/// \copydoc binary_io::components::file_stream_base::is_open()
+			[[nodiscard]] bool is_open() const noexcept { return this->_fd != -1; }
+
+			/// \brief Gets the file descriptor of the shared memory backing the ring.
+			///
+			/// \return The file descriptor of the ring, or `-1` if there is none.
+			[[nodiscard]] int native_handle() const noexcept { return this->_fd; }
+
+			/// @}
+
+		protected:
+			void* _control{ nullptr };
+			std::byte* _data{ nullptr };
+			std::size_t _capacity{ 0 };
+
+		private:
+			int _fd{ -1 };
+		};
+	}
+
+	/// \brief The consuming end of a single producer, single consumer ring buffer in shared
+	///		memory, which can be used to pass data between processes on the same host.
+	///
+	/// \remark The ring's data is mapped twice, back to back, so that every window into it is
+	///		contiguous, even when it wraps around. Waiting is done with futexes, so no system calls
+	///		are made while data is flowing freely.
+	/// \remark The stream meets the requirements of
+	///		\ref binary_io::concepts::sequential_input_stream.
+	/// \remark Only available on Linux.
+	class ring_istream final :
+		public components::ring_stream_base,
+		public binary_io::istream_interface<ring_istream>
+	{
+	private:
+		using super = components::ring_stream_base;
+
+	public:
+		ring_istream() noexcept = default;
+		ring_istream(const ring_istream&) = delete;
+		ring_istream(ring_istream&&) noexcept = default;
+
+		~ring_istream() noexcept { this->close(); }
+
+		ring_istream& operator=(const ring_istream&) = delete;
+
+		ring_istream& operator=(ring_istream&& a_rhs) noexcept
+		{
+			if (this != &a_rhs) {
+				this->close();
+				super::operator=(std::move(a_rhs));
+				istream_interface::operator=(a_rhs);
+			}
+			return *this;
+		}
+
+		/// \name File operations
+		/// @{
+
+		/// \brief Detaches from the ring, waking the producer, if applicable.
+		///
+		/// \remark Once the consumer is detached, further writes by the producer fail.
+		/// \post \ref is_open() is `false`.
+		void close() noexcept;
+
+		/// @}
+
+		/// \name Position
+		/// @{
+
+		/// \brief Gets the number of bytes which have been read from the ring.
+		///
+		/// \pre \ref is_open() _must_ be `true`.
+		/// \return The current stream position.
+		[[nodiscard]] binary_io::streamoff tell() const noexcept;
+
+		/// @}
+
+		/// \name Reading
+		/// @{
+
+		/// \copydoc binary_io::pipe_istream::at_end()
+		[[nodiscard]] bool at_end();
+
+		/// \brief Reads bytes into the given buffer, blocking until they have all arrived.
+		///
+		/// \exception binary_io::buffer_exhausted Thrown when the producer detaches before
+		///		the requested number of bytes have arrived. Those which did arrive are consumed.
+		/// \pre \ref is_open() _must_ be `true`.
+		/// \param a_dst The buffer to read bytes into.
+		void read_bytes(std::span<std::byte> a_dst);
+
+		/// @}
+	};
+
+	/// \brief The producing end of a single producer, single consumer ring buffer in shared
+	///		memory, which can be used to pass data between processes on the same host.
+	///
+	/// \remark Values are encoded directly into the shared memory, through \ref prepare() and
+	///		\ref commit().
+	/// \remark The stream meets the requirements of
+	///		\ref binary_io::concepts::sequential_output_stream and
+	///		\ref binary_io::concepts::contiguous_output_stream.
+	/// \remark Only available on Linux.
+	class ring_ostream final :
+		public components::ring_stream_base,
+		public binary_io::ostream_interface<ring_ostream>
+	{
+	private:
+		using super = components::ring_stream_base;
+
+	public:
+		ring_ostream() noexcept = default;
+		ring_ostream(const ring_ostream&) = delete;
+		ring_ostream(ring_ostream&&) noexcept = default;
+
+		~ring_ostream() noexcept { this->close(); }
+
+		ring_ostream& operator=(const ring_ostream&) = delete;
+
+		ring_ostream& operator=(ring_ostream&& a_rhs) noexcept
+		{
+			if (this != &a_rhs) {
+				this->close();
+				super::operator=(std::move(a_rhs));
+				ostream_interface::operator=(a_rhs);
+			}
+			return *this;
+		}
+
+		/// \name File operations
+		/// @{
+
+		/// \brief Detaches from the ring, waking the consumer, if applicable.
+		///
+		/// \remark Once the producer is detached, the consumer sees the end of the stream after
+		///		reading whatever is left in the ring.
+		/// \post \ref is_open() is `false`.
+		void close() noexcept;
+
+		/// @}
+
+		/// \name Position
+		/// @{
+
+		/// \brief Gets the number of bytes which have been written to the ring.
+		///
+		/// \pre \ref is_open() _must_ be `true`.
+		/// \return The current stream position.
+		[[nodiscard]] binary_io::streamoff tell() const noexcept;
+
+		/// @}
+
+		/// \name Writing
+		/// @{
+
+		/// \brief Provides a writable window of `a_count` bytes in the ring, blocking until the
+		///		consumer has made enough room.
+		///
+		/// \remark Bytes written into the window are not visible to the consumer until they are
+		///		committed.
+		/// \exception binary_io::buffer_exhausted Thrown when `a_count` is greater than the
+		///		capacity of the ring.
+		/// \exception std::system_error Thrown when the consumer has detached.
+		/// \pre \ref is_open() _must_ be `true`.
+		/// \param a_count The size of the window.
+		/// \return The writable window.
+		[[nodiscard]] auto prepare(std::size_t a_count) -> std::span<std::byte>;
+
+		/// \brief Publishes `a_count` bytes written into the window provided by \ref prepare()
+		///		to the consumer.
+		///
+		/// \pre `a_count` _must_ be less than or equal to the size of the prepared window.
+		/// \param a_count The number of bytes to commit.
+		void commit(std::size_t a_count) noexcept;
+
+		/// \brief Writes bytes from the given buffer, blocking whenever the ring is full.
+		///
+		/// \exception std::system_error Thrown when the consumer has detached.
+		/// \pre \ref is_open() _must_ be `true`.
+		/// \param a_src The buffer to write bytes from.
+		void write_bytes(std::span<const std::byte> a_src);
+
+		/// @}
+
+	private:
+		std::size_t wait_for_room(std::size_t a_count);
+	};
+}
+#endif
@@ -0,0 +1,921 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <optional>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "binary_io/common.hpp"
+
+namespace binary_io
+{
+#ifndef DOXYGEN
+	namespace detail::serialization
+	{
+		// decodes values from bytes which have already been bounds checked as a whole
+		class unchecked_istream final :
+			public components::basic_seek_stream,
+			public binary_io::istream_interface<unchecked_istream>
+		{
+		public:
+			unchecked_istream(
+				std::span<const std::byte> a_bytes,
+				std::endian a_endian) noexcept :
+				_bytes(a_bytes)
+			{
+				this->endian(a_endian);
+			}
+
+			void read_bytes(std::span<std::byte> a_dst) noexcept
+			{
+				const auto bytes = this->read_bytes(a_dst.size_bytes());
+				if (!bytes.empty()) {
+					std::memcpy(a_dst.data(), bytes.data(), bytes.size_bytes());
+				}
+			}
+
+			[[nodiscard]] auto read_bytes(std::size_t a_count) noexcept
+				-> std::span<const std::byte>
+			{
+				const auto where = static_cast<std::size_t>(this->tell());
+				assert(where + a_count <= this->_bytes.size() &&
+					   "value read more bytes than its serialized size");
+				this->seek_relative(static_cast<binary_io::streamoff>(a_count));
+				return this->_bytes.subspan(where, a_count);
+			}
+
+		private:
+			std::span<const std::byte> _bytes;
+		};
+
+		// encodes values into a window which has already been reserved as a whole
+		class unchecked_ostream final :
+			public components::basic_seek_stream,
+			public binary_io::ostream_interface<unchecked_ostream>
+		{
+		public:
+			unchecked_ostream(
+				std::span<std::byte> a_bytes,
+				std::endian a_endian) noexcept :
+				_bytes(a_bytes)
+			{
+				this->endian(a_endian);
+			}
+
+			void write_bytes(std::span<const std::byte> a_src) noexcept
+			{
+				const auto bytes = this->prepare(a_src.size_bytes());
+				if (!bytes.empty()) {
+					std::memcpy(bytes.data(), a_src.data(), a_src.size_bytes());
+				}
+				this->commit(a_src.size_bytes());
+			}
+
+			[[nodiscard]] auto prepare(std::size_t a_count) noexcept
+				-> std::span<std::byte>
+			{
+				const auto where = static_cast<std::size_t>(this->tell());
+				assert(where + a_count <= this->_bytes.size() &&
+					   "value wrote more bytes than its serialized size");
+				return this->_bytes.subspan(where, a_count);
+			}
+
+			void commit(std::size_t a_count) noexcept
+			{
+				this->seek_relative(static_cast<binary_io::streamoff>(a_count));
+			}
+
+		private:
+			std::span<std::byte> _bytes;
+		};
+
+		// serializers for standard library types, which are specialized at the end of this header
+		template <class T>
+		struct builtin
+		{
+			static constexpr bool enabled = false;
+		};
+
+		// unqualified calls below find these, and otherwise only what ADL finds
+		void serialize() = delete;
+		void deserialize() = delete;
+		constexpr void serialized_size() = delete;
+
+		template <class T>
+		concept declared_size =
+			(builtin<T>::enabled &&
+				requires {
+					typename std::integral_constant<
+						std::size_t,
+						builtin<T>::static_size()>;
+				}) ||
+			(!builtin<T>::enabled &&
+				requires {
+					typename std::integral_constant<
+						std::size_t,
+						serialized_size(std::type_identity<T>{})>;
+				});
+
+		template <class T>
+		concept computed_size =
+			(builtin<T>::enabled &&
+				requires(const T& a_value) {
+					// clang-format off
+					{ builtin<T>::dynamic_size(a_value) } -> std::convertible_to<std::size_t>;
+					// clang-format on
+				}) ||
+			(!builtin<T>::enabled &&
+				requires(const T& a_value) {
+					// clang-format off
+					{ serialized_size(a_value) } -> std::convertible_to<std::size_t>;
+					// clang-format on
+				});
+
+		template <class T>
+		concept fixed_size =
+			concepts::integral<T> ||
+			declared_size<T>;
+
+		template <class T>
+		concept sized =
+			fixed_size<T> ||
+			computed_size<T>;
+
+		template <class Stream, class T>
+		concept custom_serializable =
+			(builtin<T>::enabled &&
+				requires(Stream& a_out, const T& a_value) {
+					{ builtin<T>::write(a_out, a_value) };
+				}) ||
+			(!builtin<T>::enabled &&
+				requires(Stream& a_out, const T& a_value) {
+					{ serialize(a_out, a_value) };
+				});
+
+		template <class Stream, class T>
+		concept custom_deserializable =
+			(builtin<T>::enabled &&
+				requires(Stream& a_in, T& a_value) {
+					{ builtin<T>::read(a_in, a_value) };
+				}) ||
+			(!builtin<T>::enabled &&
+				requires(Stream& a_in, T& a_value) {
+					{ deserialize(a_in, a_value) };
+				});
+
+		template <class Stream>
+		concept unchecked_stream =
+			std::same_as<Stream, unchecked_istream> ||
+			std::same_as<Stream, unchecked_ostream>;
+
+		template <class T>
+		[[nodiscard]] consteval std::size_t size_of() noexcept
+		{
+			if constexpr (concepts::integral<T>) {
+				return sizeof(T);
+			} else if constexpr (builtin<T>::enabled) {
+				return builtin<T>::static_size();
+			} else {
+				return serialized_size(std::type_identity<T>{});
+			}
+		}
+
+		template <class T>
+		[[nodiscard]] std::size_t size_of(const T& a_value)
+		{
+			if constexpr (fixed_size<T>) {
+				return size_of<T>();
+			} else if constexpr (builtin<T>::enabled) {
+				return builtin<T>::dynamic_size(a_value);
+			} else {
+				return static_cast<std::size_t>(serialized_size(a_value));
+			}
+		}
+
+		template <class Stream, class T>
+		void custom_write(Stream& a_out, const T& a_value)
+		{
+			if constexpr (builtin<T>::enabled) {
+				builtin<T>::write(a_out, a_value);
+			} else {
+				serialize(a_out, a_value);
+			}
+		}
+
+		template <class Stream, class T>
+		void custom_read(Stream& a_in, T& a_value)
+		{
+			if constexpr (builtin<T>::enabled) {
+				builtin<T>::read(a_in, a_value);
+			} else {
+				deserialize(a_in, a_value);
+			}
+		}
+
+		template <std::size_t N, class Stream, class F>
+		void read_fixed(Stream& a_in, F&& a_decode)
+		{
+			if constexpr (concepts::no_copy_input_stream<Stream>) {
+				unchecked_istream in{ a_in.read_bytes(N), a_in.endian() };
+				a_decode(in);
+			} else {
+				std::array<std::byte, N> buffer{};
+				a_in.read_bytes(std::span{ buffer });
+				unchecked_istream in{ std::span{ std::as_const(buffer) }, a_in.endian() };
+				a_decode(in);
+			}
+		}
+
+		template <class Stream, class F>
+		void write_window(Stream& a_out, std::size_t a_size, F&& a_encode)
+		{
+			unchecked_ostream out{ a_out.prepare(a_size), a_out.endian() };
+			a_encode(out);
+			assert(static_cast<std::size_t>(out.tell()) == a_size &&
+				   "value wrote fewer bytes than its serialized size");
+			a_out.commit(a_size);
+		}
+
+		template <std::size_t N, class Stream, class F>
+		void write_fixed(Stream& a_out, F&& a_encode)
+		{
+			if constexpr (concepts::contiguous_output_stream<Stream>) {
+				write_window(a_out, N, std::forward<F>(a_encode));
+			} else {
+				std::array<std::byte, N> buffer{};
+				unchecked_ostream out{ std::span{ buffer }, a_out.endian() };
+				a_encode(out);
+				assert(static_cast<std::size_t>(out.tell()) == N &&
+					   "value wrote fewer bytes than its serialized size");
+				a_out.write_bytes(std::span{ std::as_const(buffer) });
+			}
+		}
+
+		template <class Stream, class T>
+		concept serializable =
+			concepts::integral<T> ||
+			(declared_size<T> && custom_serializable<unchecked_ostream, T>) ||
+			(!declared_size<T> && custom_serializable<Stream, T>);
+
+		template <class Stream, class T>
+		concept deserializable =
+			concepts::integral<T> ||
+			(declared_size<T> && custom_deserializable<unchecked_istream, T>) ||
+			(!declared_size<T> && custom_deserializable<Stream, T>);
+
+		// values whose size is known before they are encoded, and so can share one window
+		template <class T>
+		concept presizable =
+			fixed_size<T> ||
+			(computed_size<T> && custom_serializable<unchecked_ostream, T>);
+
+		template <class Stream, class T>
+		void serialize_one(Stream& a_out, const T& a_value)
+		{
+			if constexpr (concepts::integral<T>) {
+				a_out.write(a_value);
+			} else if constexpr (unchecked_stream<Stream>) {
+				custom_write(a_out, a_value);
+			} else if constexpr (declared_size<T>) {
+				write_fixed<size_of<T>()>(a_out, [&](unchecked_ostream& a_fixed) {
+					custom_write(a_fixed, a_value);
+				});
+			} else if constexpr (presizable<T> && concepts::contiguous_output_stream<Stream>) {
+				write_window(a_out, size_of(a_value), [&](unchecked_ostream& a_window) {
+					custom_write(a_window, a_value);
+				});
+			} else {
+				custom_write(a_out, a_value);
+			}
+		}
+
+		template <class Stream, class T>
+		void deserialize_one(Stream& a_in, T& a_value)
+		{
+			if constexpr (concepts::integral<T>) {
+				a_in.read(a_value);
+			} else if constexpr (declared_size<T> && !unchecked_stream<Stream>) {
+				read_fixed<size_of<T>()>(a_in, [&](unchecked_istream& a_fixed) {
+					custom_read(a_fixed, a_value);
+				});
+			} else {
+				custom_read(a_in, a_value);
+			}
+		}
+
+		struct serialize_fn
+		{
+			template <class Stream, class... Args>
+			requires(sizeof...(Args) > 0 && (serializable<Stream, Args> && ...))
+			void operator()(Stream& a_out, const Args&... a_values) const
+			{
+				if constexpr (sizeof...(Args) == 1 || unchecked_stream<Stream>) {
+					(serialize_one(a_out, a_values), ...);
+				} else if constexpr ((fixed_size<Args> && ...)) {
+					write_fixed<(size_of<Args>() + ...)>(a_out, [&](unchecked_ostream& a_fixed) {
+						(serialize_one(a_fixed, a_values), ...);
+					});
+				} else if constexpr ((presizable<Args> && ...) && concepts::contiguous_output_stream<Stream>) {
+					write_window(a_out, (size_of(a_values) + ...), [&](unchecked_ostream& a_window) {
+						(serialize_one(a_window, a_values), ...);
+					});
+				} else {
+					(serialize_one(a_out, a_values), ...);
+				}
+			}
+		};
+
+		struct deserialize_fn
+		{
+			template <class Stream, class... Args>
+			requires(sizeof...(Args) > 0 && (deserializable<Stream, Args> && ...))
+			void operator()(Stream& a_in, Args&... a_values) const
+			{
+				if constexpr (sizeof...(Args) > 1 && (fixed_size<Args> && ...) && !unchecked_stream<Stream>) {
+					read_fixed<(size_of<Args>() + ...)>(a_in, [&](unchecked_istream& a_fixed) {
+						(deserialize_one(a_fixed, a_values), ...);
+					});
+				} else {
+					(deserialize_one(a_in, a_values), ...);
+				}
+			}
+		};
+
+		struct serialized_size_fn
+		{
+			template <class T>
+			requires(fixed_size<T> || computed_size<T>)
+				[[nodiscard]] std::size_t operator()(const T& a_value) const
+			{
+				return size_of(a_value);
+			}
+		};
+
+		// ranges of scalars in the stream's byte order are copied in bulk, and ranges of fixed
+		// size values are encoded through one window, or a few stack sized chunks
+		inline constexpr std::size_t range_chunk_size = 1u << 12;
+
+		template <class Stream, class T>
+		void write_range(Stream& a_out, std::span<const T> a_values)
+		{
+			if constexpr (concepts::integral<T>) {
+				if (sizeof(T) == 1 || a_out.endian() == std::endian::native) {
+					a_out.write_bytes(std::as_bytes(a_values));
+					return;
+				}
+			}
+
+			if constexpr (fixed_size<T> && !unchecked_stream<Stream>) {
+				constexpr auto size = size_of<T>();
+				if constexpr (concepts::contiguous_output_stream<Stream>) {
+					write_window(a_out, a_values.size() * size, [&](unchecked_ostream& a_window) {
+						for (const auto& value : a_values) {
+							serialize_one(a_window, value);
+						}
+					});
+					return;
+				} else if constexpr (size != 0 && size <= range_chunk_size) {
+					constexpr auto per = range_chunk_size / size;
+					std::array<std::byte, per * size> buffer{};
+					for (std::size_t i = 0; i < a_values.size(); i += per) {
+						const auto chunk = a_values.subspan(i, std::min(per, a_values.size() - i));
+						const auto bytes = std::span{ buffer }.first(chunk.size() * size);
+						unchecked_ostream out{ bytes, a_out.endian() };
+						for (const auto& value : chunk) {
+							serialize_one(out, value);
+						}
+						a_out.write_bytes(std::span{ std::as_const(buffer) }.first(bytes.size()));
+					}
+					return;
+				}
+			}
+
+			for (const auto& value : a_values) {
+				serialize_one(a_out, value);
+			}
+		}
+
+		template <class Stream, class T>
+		void read_range(Stream& a_in, std::span<T> a_values)
+		{
+			if constexpr (concepts::integral<T>) {
+				a_in.read_bytes(std::as_writable_bytes(a_values));
+				if (sizeof(T) != 1 && a_in.endian() != std::endian::native) {
+					for (auto& value : a_values) {
+						value = binary_io::endian::reverse(value);
+					}
+				}
+			} else if constexpr (fixed_size<T> && concepts::no_copy_input_stream<Stream>) {
+				unchecked_istream in{ a_in.read_bytes(a_values.size() * size_of<T>()), a_in.endian() };
+				for (auto& value : a_values) {
+					deserialize_one(in, value);
+				}
+			} else {
+				for (auto& value : a_values) {
+					deserialize_one(a_in, value);
+				}
+			}
+		}
+
+		// containers are prefixed with their element count
+		using count_type = std::uint64_t;
+
+		template <class Stream>
+		[[nodiscard]] std::size_t read_count(Stream& a_in, std::size_t a_elementSize)
+		{
+			count_type count = 0;
+			deserialize_one(a_in, count);
+			if (count > std::numeric_limits<std::size_t>::max() / std::max<std::size_t>(a_elementSize, 1)) {
+				throw binary_io::buffer_exhausted();
+			}
+			return static_cast<std::size_t>(count);
+		}
+
+		// the most bytes a container allocates ahead of the elements which fill them, when the
+		// count can't be checked against the input first
+		inline constexpr std::size_t max_reserve = std::size_t{ 1 } << 16;
+
+		template <class T>
+		[[nodiscard]] consteval std::size_t reserve_limit() noexcept
+		{
+			return std::max<std::size_t>(max_reserve / sizeof(T), 1);
+		}
+
+		// reads `a_count` values, taking their bytes up front where the stream allows it, so that
+		// an impossible count fails before anything is allocated for it
+		template <std::size_t ElementSize, class Stream, class F>
+		void read_elements(Stream& a_in, std::size_t a_count, F&& a_decode)
+		{
+			if constexpr (ElementSize != 0 && concepts::no_copy_input_stream<Stream> && !unchecked_stream<Stream>) {
+				unchecked_istream in{ a_in.read_bytes(a_count * ElementSize), a_in.endian() };
+				a_decode(in);
+			} else {
+				a_decode(a_in);
+			}
+		}
+
+		template <class T>
+		[[nodiscard]] consteval std::size_t element_size() noexcept
+		{
+			if constexpr (fixed_size<T>) {
+				return size_of<T>();
+			} else {
+				return 0;
+			}
+		}
+
+		template <class T, std::size_t N>
+		struct builtin<std::array<T, N>>
+		{
+			static constexpr bool enabled = true;
+
+			[[nodiscard]] static consteval std::size_t static_size() noexcept
+				requires(fixed_size<T>)
+			{
+				return N * size_of<T>();
+			}
+
+			[[nodiscard]] static std::size_t dynamic_size(const std::array<T, N>& a_value)  //
+				requires(computed_size<T>)
+			{
+				std::size_t result = 0;
+				for (const auto& value : a_value) {
+					result += size_of(value);
+				}
+				return result;
+			}
+
+			template <class Stream>
+			requires(serializable<Stream, T>) static void write(
+				Stream& a_out,
+				const std::array<T, N>& a_value)
+			{
+				write_range(a_out, std::span<const T>{ a_value });
+			}
+
+			template <class Stream>
+			requires(deserializable<Stream, T>) static void read(
+				Stream& a_in,
+				std::array<T, N>& a_value)
+			{
+				read_range(a_in, std::span<T>{ a_value });
+			}
+		};
+
+		template <class T, class Allocator>
+		struct builtin<std::vector<T, Allocator>>
+		{
+			static constexpr bool enabled = true;
+
+			[[nodiscard]] static std::size_t dynamic_size(const std::vector<T, Allocator>& a_value)  //
+				requires(sized<T>)
+			{
+				if constexpr (fixed_size<T>) {
+					return sizeof(count_type) + a_value.size() * size_of<T>();
+				} else {
+					std::size_t result = sizeof(count_type);
+					for (const auto& value : a_value) {
+						result += size_of(value);
+					}
+					return result;
+				}
+			}
+
+			template <class Stream>
+			requires(serializable<Stream, T>) static void write(
+				Stream& a_out,
+				const std::vector<T, Allocator>& a_value)
+			{
+				serialize_one(a_out, static_cast<count_type>(a_value.size()));
+				write_range(a_out, std::span<const T>{ a_value });
+			}
+
+			template <class Stream>
+			requires(deserializable<Stream, T> && std::default_initializable<T>) static void read(
+				Stream& a_in,
+				std::vector<T, Allocator>& a_value)
+			{
+				constexpr auto size = element_size<T>();
+				const auto count = read_count(a_in, size);
+				read_elements<size>(a_in, count, [&]<class Elements>(Elements& a_elements) {
+					a_value.clear();
+					if constexpr (unchecked_stream<Elements>) {
+						a_value.resize(count);
+						read_range(a_elements, std::span<T>{ a_value });
+					} else {
+						// the count is untrusted, so only grow as fast as the elements decode
+						while (a_value.size() < count) {
+							const auto first = a_value.size();
+							a_value.resize(first + std::min(count - first, reserve_limit<T>()));
+							read_range(a_elements, std::span<T>{ a_value }.subspan(first));
+						}
+					}
+				});
+			}
+		};
+
+		template <class T>
+		struct builtin<std::optional<T>>
+		{
+			static constexpr bool enabled = true;
+
+			[[nodiscard]] static std::size_t dynamic_size(const std::optional<T>& a_value)  //
+				requires(sized<T>)
+			{
+				return 1 + (a_value ? size_of(*a_value) : 0);
+			}
+
+			template <class Stream>
+			requires(serializable<Stream, T>) static void write(
+				Stream& a_out,
+				const std::optional<T>& a_value)
+			{
+				serialize_one(a_out, static_cast<std::uint8_t>(a_value.has_value()));
+				if (a_value) {
+					serialize_one(a_out, *a_value);
+				}
+			}
+
+			template <class Stream>
+			requires(deserializable<Stream, T> && std::default_initializable<T>) static void read(
+				Stream& a_in,
+				std::optional<T>& a_value)
+			{
+				std::uint8_t engaged = 0;
+				deserialize_one(a_in, engaged);
+				switch (engaged) {
+				case 0:
+					a_value.reset();
+					break;
+				case 1:
+					deserialize_one(a_in, a_value ? *a_value : a_value.emplace());
+					break;
+				default:
+					throw binary_io::exception("invalid optional in stream");
+				}
+			}
+		};
+
+		template <class... Ts>
+		struct builtin<std::variant<Ts...>>
+		{
+			static_assert(sizeof...(Ts) <= UINT8_MAX, "too many variant alternatives to serialize");
+
+			static constexpr bool enabled = true;
+
+			[[nodiscard]] static std::size_t dynamic_size(const std::variant<Ts...>& a_value)  //
+				requires((sized<Ts> && ...))
+			{
+				return 1 + std::visit([](const auto& a_alternative) { return size_of(a_alternative); }, a_value);
+			}
+
+			template <class Stream>
+			requires((serializable<Stream, Ts> && ...)) static void write(
+				Stream& a_out,
+				const std::variant<Ts...>& a_value)
+			{
+				if (a_value.valueless_by_exception()) {
+					throw binary_io::exception("can not serialize a valueless variant");
+				}
+
+				serialize_one(a_out, static_cast<std::uint8_t>(a_value.index()));
+				std::visit([&](const auto& a_alternative) { serialize_one(a_out, a_alternative); }, a_value);
+			}
+
+			template <class Stream>
+			requires((deserializable<Stream, Ts> && ...) && (std::default_initializable<Ts> && ...)) static void read(
+				Stream& a_in,
+				std::variant<Ts...>& a_value)
+			{
+				std::uint8_t index = 0;
+				deserialize_one(a_in, index);
+				if (index >= sizeof...(Ts)) {
+					throw binary_io::exception("invalid variant in stream");
+				}
+
+				[&]<std::size_t... I>(std::index_sequence<I...>) {
+					((index == I ? deserialize_one(a_in, a_value.template emplace<I>()) : void()), ...);
+				}
+				(std::index_sequence_for<Ts...>{});
+			}
+		};
+
+		template <class Tuple, class... Ts>
+		struct tuple_builtin
+		{
+			static constexpr bool enabled = true;
+
+			[[nodiscard]] static consteval std::size_t static_size() noexcept
+				requires((fixed_size<Ts> && ...))
+			{
+				return (std::size_t{ 0 } + ... + size_of<Ts>());
+			}
+
+			[[nodiscard]] static std::size_t dynamic_size(const Tuple& a_value)  //
+				requires((sized<Ts> && ...))
+			{
+				return std::apply(
+					[](const auto&... a_elements) {
+						return (std::size_t{ 0 } + ... + size_of(a_elements));
+					},
+					a_value);
+			}
+
+			template <class Stream>
+			requires((serializable<Stream, Ts> && ...)) static void write(
+				Stream& a_out,
+				const Tuple& a_value)
+			{
+				std::apply(
+					[&](const auto&... a_elements) {
+						(serialize_one(a_out, a_elements), ...);
+					},
+					a_value);
+			}
+
+			template <class Stream>
+			requires((deserializable<Stream, Ts> && ...)) static void read(
+				Stream& a_in,
+				Tuple& a_value)
+			{
+				std::apply(
+					[&](auto&... a_elements) {
+						(deserialize_one(a_in, a_elements), ...);
+					},
+					a_value);
+			}
+		};
+
+		template <class... Ts>
+		struct builtin<std::tuple<Ts...>> :
+			tuple_builtin<std::tuple<Ts...>, Ts...>
+		{};
+
+		template <class T1, class T2>
+		struct builtin<std::pair<T1, T2>> :
+			tuple_builtin<std::pair<T1, T2>, T1, T2>
+		{};
+
+		template <class Map, class Key, class T>
+		struct map_builtin
+		{
+			static constexpr bool enabled = true;
+
+			[[nodiscard]] static std::size_t dynamic_size(const Map& a_value)  //
+				requires(sized<Key> && sized<T>)
+			{
+				if constexpr (fixed_size<Key> && fixed_size<T>) {
+					return sizeof(count_type) + a_value.size() * (size_of<Key>() + size_of<T>());
+				} else {
+					std::size_t result = sizeof(count_type);
+					for (const auto& [key, value] : a_value) {
+						result += size_of(key) + size_of(value);
+					}
+					return result;
+				}
+			}
+
+			template <class Stream>
+			requires(serializable<Stream, Key> && serializable<Stream, T>) static void write(
+				Stream& a_out,
+				const Map& a_value)
+			{
+				serialize_one(a_out, static_cast<count_type>(a_value.size()));
+				for (const auto& [key, value] : a_value) {
+					serialize_one(a_out, key);
+					serialize_one(a_out, value);
+				}
+			}
+
+			template <class Stream>
+			requires(
+				deserializable<Stream, Key> &&
+				deserializable<Stream, T> &&
+				std::default_initializable<Key> &&
+				std::default_initializable<T>) static void read(
+				Stream& a_in,
+				Map& a_value)
+			{
+				constexpr auto size =
+					element_size<Key>() != 0 && element_size<T>() != 0 ?
+						element_size<Key>() + element_size<T>() :
+						0;
+				const auto count = read_count(a_in, size);
+				read_elements<size>(a_in, count, [&](auto& a_elements) {
+					a_value.clear();
+					if constexpr (requires { a_value.reserve(count); }) {
+						a_value.reserve(std::min(count, reserve_limit<typename Map::value_type>()));
+					}
+					for (std::size_t i = 0; i < count; ++i) {
+						Key key{};
+						T value{};
+						deserialize_one(a_elements, key);
+						deserialize_one(a_elements, value);
+						a_value.emplace_hint(a_value.end(), std::move(key), std::move(value));
+					}
+				});
+			}
+		};
+
+		template <class Key, class T, class Compare, class Allocator>
+		struct builtin<std::map<Key, T, Compare, Allocator>> :
+			map_builtin<std::map<Key, T, Compare, Allocator>, Key, T>
+		{};
+
+		template <class Key, class T, class Hash, class KeyEqual, class Allocator>
+		struct builtin<std::unordered_map<Key, T, Hash, KeyEqual, Allocator>> :
+			map_builtin<std::unordered_map<Key, T, Hash, KeyEqual, Allocator>, Key, T>
+		{};
+	}
+#endif
+
+	namespace concepts
+	{
+#ifdef DOXYGEN
+		/// \brief A constraint for types which can be written to the given stream with
+		///		\ref binary_io::serialize.
+		///
+		/// \remark
+		/// * `T` must meet the requirements of \ref binary_io::concepts::integral, or
+		/// * `T` must be a `std::array`, `std::vector`, `std::optional`, `std::variant`,
+		///		`std::tuple`, `std::pair`, `std::map`, or `std::unordered_map` of serializable
+		///		types, or
+		/// * there must be a function `serialize(Stream&, const T&)` which can be found by ADL.
+		template <class T, class Stream>
+		struct serializable
+		{};
+#else
+		template <class T, class Stream>
+		concept serializable = detail::serialization::serializable<Stream, T>;
+#endif
+
+#ifdef DOXYGEN
+		/// \brief A constraint for types which can be read from the given stream with
+		///		\ref binary_io::deserialize.
+		///
+		/// \remark
+		/// * `T` must meet the requirements of \ref binary_io::concepts::integral, or
+		/// * `T` must be one of the standard library types listed by
+		///		\ref binary_io::concepts::serializable, of deserializable and default
+		///		constructible types, or
+		/// * there must be a function `deserialize(Stream&, T&)` which can be found by ADL.
+		template <class T, class Stream>
+		struct deserializable
+		{};
+#else
+		template <class T, class Stream>
+		concept deserializable = detail::serialization::deserializable<Stream, T>;
+#endif
+
+#ifdef DOXYGEN
+		/// \brief A constraint for types which always serialize to the same number of bytes.
+		///
+		/// \remark
+		/// * `T` must meet the requirements of \ref binary_io::concepts::integral, or
+		/// * `T` must be a `std::array`, `std::tuple`, or `std::pair` of fixed size types, or
+		/// * there must be a `constexpr` function `std::size_t serialized_size(std::type_identity<T>)`
+		///		which can be found by ADL.
+		template <class T>
+		struct fixed_size_serializable
+		{};
+#else
+		template <class T>
+		concept fixed_size_serializable = detail::serialization::fixed_size<T>;
+#endif
+	}
+
+	/// \brief Writes the given values into the given stream.
+	///
+	/// \remark User types opt in by providing `serialize(Stream& a_out, const T& a_value)`,
+	///		which is found by ADL, and should be a template over the stream type. Types which
+	///		always serialize to the same number of bytes should also declare that size through
+	///		`constexpr std::size_t serialized_size(std::type_identity<T>)`. Types whose size
+	///		depends on their value may compute it through `std::size_t serialized_size(const T&)`.
+	/// \remark When the size of every value is known up front, the values are encoded straight
+	///		into a single window of the stream, so the stream is grown and bounds checked once,
+	///		rather than once per field. Values of a declared size must write exactly that many
+	///		bytes.
+	/// \remark Standard library containers and vocabulary types are supported out of the box.
+	///		`std::vector` and the maps are prefixed with their size as a `std::uint64_t`,
+	///		`std::optional` with a `std::uint8_t` which is `1` when it holds a value, and
+	///		`std::variant` with the index of its alternative as a `std::uint8_t`. `std::array`,
+	///		`std::tuple`, and `std::pair` are written as their elements, back to back. Arrays and
+	///		vectors of integral values in the stream's endian format are written with a single
+	///		`write_bytes`.
+	/// \remark Call as `binary_io::serialize(a_out, a_values...)`.
+	inline constexpr detail::serialization::serialize_fn serialize{};
+
+	/// \brief Reads the given values from the given stream.
+	///
+	/// \remark User types opt in by providing `deserialize(Stream& a_in, T& a_value)`, which is
+	///		found by ADL, and should be a template over the stream type.
+	/// \remark When every value has a declared size, their bytes are read from the stream with a
+	///		single bounds checked `read_bytes`, and the values are decoded from those bytes without
+	///		any further checks, just like a batch of integral values. Values of a declared size
+	///		must read exactly that many bytes.
+	/// \remark Vectors and maps are allocated once, from their size prefix. When their values
+	///		have a fixed size and the stream meets the requirements of
+	///		\ref binary_io::concepts::no_copy_input_stream, the prefix is bounds checked before
+	///		anything is allocated. Arrays and vectors of integral values are read with a single
+	///		`read_bytes`.
+	/// \remark Call as `binary_io::deserialize(a_in, a_values...)`.
+	/// \exception binary_io::exception Thrown when an optional or variant holds an invalid tag.
+	inline constexpr detail::serialization::deserialize_fn deserialize{};
+
+	/// \brief Gets the number of bytes the given value serializes to.
+	///
+	/// \remark Only available for types which declare or compute their size.
+	/// \remark Call as `binary_io::serialized_size(a_value)`.
+	inline constexpr detail::serialization::serialized_size_fn serialized_size{};
+
+	/// \brief The number of bytes every value of the given type serializes to.
+	///
+	/// \tparam T A type which meets the requirements of
+	///		\ref binary_io::concepts::fixed_size_serializable.
+	template <concepts::fixed_size_serializable T>
+	inline constexpr std::size_t serialized_size_v = detail::serialization::size_of<T>();
+
+	/// \brief Writes the given value into the output stream, with \ref serialize.
+	///
+	/// \param a_out The output stream to write to.
+	/// \param a_value The value to be written into the output stream.
+	/// \return A reference to the output stream, for chaining.
+	template <class Derived, class T>
+	requires(!concepts::integral<T> && concepts::serializable<T, Derived>)
+		Derived& operator<<(
+			binary_io::ostream_interface<Derived>& a_out,
+			const T& a_value)
+	{
+		auto& out = static_cast<Derived&>(a_out);
+		binary_io::serialize(out, a_value);
+		return out;
+	}
+
+	/// \brief Reads the given value from the input stream, with \ref deserialize.
+	///
+	/// \param a_in The input stream to read from.
+	/// \param a_value The value to be read from the input stream.
+	/// \return A reference to the input stream, for chaining.
+	template <class Derived, class T>
+	requires(!concepts::integral<T> && concepts::deserializable<T, Derived>)
+		Derived& operator>>(
+			binary_io::istream_interface<Derived>& a_in,
+			T& a_value)
+	{
+		auto& in = static_cast<Derived&>(a_in);
+		binary_io::deserialize(in, a_value);
+		return in;
+	}
+}
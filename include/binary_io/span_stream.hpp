@@ -4,6 +4,7 @@
 #include <span>
 
 #include "binary_io/common.hpp"
+#include "binary_io/copy_policy.hpp"
 
 namespace binary_io
 {
@@ -48,8 +49,11 @@ namespace binary_io
 	}
 
 	/// \brief A stream which composes a non-owning view over a contiguous block of memory.
+	///
+	/// \remark Reads are copied according to the stream's \ref copy_policy.
 	class span_istream final :
 		public components::span_stream_base<const std::byte>,
+		public components::basic_copy_stream,
 		public binary_io::istream_interface<span_istream>
 	{
 	private:
@@ -79,9 +83,12 @@ namespace binary_io
 		/// @}
 	};
 
-	/// \copydoc span_istream
+	/// \brief A stream which composes a non-owning view over a contiguous block of memory.
+	///
+	/// \remark Writes are copied according to the stream's \ref copy_policy.
 	class span_ostream final :
 		public components::span_stream_base<std::byte>,
+		public components::basic_copy_stream,
 		public binary_io::ostream_interface<span_ostream>
 	{
 	private:
@@ -100,6 +107,24 @@ namespace binary_io
 		/// \param a_src The buffer to write bytes from.
 		void write_bytes(std::span<const std::byte> a_src);
 
+		/// \brief Provides a writable window of `a_count` bytes at the current position.
+		///
+		/// \remark Bytes written into the window are not part of the stream until they are committed.
+		/// \exception binary_io::buffer_exhausted Thrown when the buffer has less than the
+		///		requested number of bytes.
+		/// \param a_count The size of the window.
+		/// \return The writable window.
+		[[nodiscard]] auto prepare(std::size_t a_count) -> std::span<std::byte>;
+
+		/// \brief Commits `a_count` bytes written into the window provided by \ref prepare().
+		///
+		/// \pre `a_count` _must_ be less than or equal to the size of the prepared window.
+		/// \param a_count The number of bytes to commit.
+		void commit(std::size_t a_count) noexcept
+		{
+			this->seek_relative(static_cast<binary_io::streamoff>(a_count));
+		}
+
 		/// @}
 	};
 }
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <span>
+
+#include "binary_io/common.hpp"
+
+namespace binary_io
+{
+	/// \brief A stream which composes a bounded window over another input stream.
+	///
+	/// \remark Positions are relative to the start of the window. The underlying stream is
+	///		only repositioned when it has been moved since the last read.
+	/// \tparam Stream A stream type which meets the requirements of \ref binary_io::concepts::input_stream.
+	template <class Stream>
+	class sub_istream final :
+		public components::basic_seek_stream,
+		public binary_io::istream_interface<sub_istream<Stream>>
+	{
+	public:
+		using stream_type = Stream;
+
+		/// \brief Constructs an empty window.
+		sub_istream() noexcept = default;
+
+		/// \brief Constructs a window over the given stream.
+		///
+		/// \param a_stream The underlying stream. It _must_ outlive the window.
+		/// \param a_offset The absolute position of the window within the underlying stream.
+		/// \param a_size The size of the window, in bytes.
+		sub_istream(
+			stream_type& a_stream,
+			binary_io::streamoff a_offset,
+			std::size_t a_size) noexcept :
+			_stream(std::addressof(a_stream)),
+			_offset(a_offset),
+			_size(a_size)
+		{}
+
+		/// \name Buffer management
+		/// @{
+
+		/// \brief Provides access to the underlying stream.
+		///
+		/// \return The underlying stream.
+		[[nodiscard]] stream_type* rdbuf() noexcept { return this->_stream; }
+
+		/// \copydoc rdbuf()
+		[[nodiscard]] const stream_type* rdbuf() const noexcept { return this->_stream; }
+
+		/// \brief Gets the absolute position of the window within the underlying stream.
+		///
+		/// \return The position of the window.
+		[[nodiscard]] binary_io::streamoff offset() const noexcept { return this->_offset; }
+
+		/// \brief Gets the size of the window.
+		///
+		/// \return The size of the window, in bytes.
+		[[nodiscard]] std::size_t size() const noexcept { return this->_size; }
+
+		/// @}
+
+		/// \name Reading
+		/// @{
+
+		/// \copydoc span_istream::read_bytes
+		void read_bytes(std::span<std::byte> a_dst)
+		{
+			if (a_dst.empty()) {
+				return;
+			}
+
+			this->prepare(a_dst.size_bytes());
+			this->_stream->read_bytes(a_dst);
+			this->seek_relative(static_cast<binary_io::streamoff>(a_dst.size_bytes()));
+		}
+
+		/// \copydoc span_istream::read_bytes(std::size_t)
+		[[nodiscard]] auto read_bytes(std::size_t a_count)
+			-> std::span<const std::byte>  //
+			requires(concepts::no_copy_input_stream<stream_type>)
+		{
+			if (a_count == 0) {
+				return {};
+			}
+
+			this->prepare(a_count);
+			const auto result = this->_stream->read_bytes(a_count);
+			this->seek_relative(static_cast<binary_io::streamoff>(a_count));
+			return result;
+		}
+
+		/// @}
+
+	private:
+		void prepare(std::size_t a_count)
+		{
+			const auto where = this->tell();
+			assert(where >= 0);
+			if (static_cast<std::size_t>(where) > this->_size ||
+				this->_size - static_cast<std::size_t>(where) < a_count) {
+				throw binary_io::buffer_exhausted();
+			}
+
+			assert(this->_stream != nullptr);
+			const auto pos = this->_offset + where;
+			if (this->_stream->tell() != pos) {
+				this->_stream->seek_absolute(pos);
+			}
+		}
+
+		stream_type* _stream{ nullptr };
+		binary_io::streamoff _offset{ 0 };
+		std::size_t _size{ 0 };
+	};
+}
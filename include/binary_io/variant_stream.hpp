@@ -0,0 +1,244 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "binary_io/common.hpp"
+
+namespace binary_io
+{
+	namespace components
+	{
+		/// \brief Implements the common interface of every `variant_stream`.
+		template <class... Streams>
+		class variant_stream_base
+		{
+		public:
+			using variant_type = std::variant<Streams...>;
+
+			/// \brief Default constructs the first alternative.
+			variant_stream_base() = default;
+
+			/// \brief Uses the given stream as the active alternative.
+			///
+			/// \param a_stream The stream to copy or move from.
+			template <class S>
+			requires((std::same_as<std::remove_cvref_t<S>, Streams> || ...))
+				variant_stream_base(S&& a_stream)  //
+				noexcept(std::is_nothrow_constructible_v<variant_type, S&&>) :
+				_streams(std::forward<S>(a_stream))
+			{}
+
+			/// \copydoc emplace()
+			template <class S, class... Args>
+			variant_stream_base(std::in_place_type_t<S> a_type, Args&&... a_args) :
+				_streams(a_type, std::forward<Args>(a_args)...)
+			{}
+
+			/// \name Buffering
+			/// @{
+
+			/// \brief Flushes the active stream's buffers, if applicable.
+			void flush() noexcept
+			{
+				this->visit([](auto& a_stream) noexcept {
+					if constexpr (concepts::buffered_stream<std::remove_cvref_t<decltype(a_stream)>>) {
+						a_stream.flush();
+					}
+				});
+			}
+
+			/// @}
+
+			/// \name Modifiers
+			/// @{
+
+			/// \brief Constructs the given alternative in-place, using the given arguments.
+			///
+			/// \tparam S The stream to construct in-place.
+			/// \tparam Args The arg types.
+			/// \param a_args The arguments to use to construct the stream in-place.
+			/// \return The newly constructed stream.
+			template <class S, class... Args>
+			S& emplace(Args&&... a_args)
+			{
+				return this->_streams.template emplace<S>(std::forward<Args>(a_args)...);
+			}
+
+			/// @}
+
+			/// \name Observers
+			/// @{
+
+			/// \brief Gets the active stream as the given type.
+			///
+			/// \exception std::bad_variant_access Thrown if the active stream is _not_ of the given type.
+			/// \tparam S The type of the stream to get.
+			/// \return The active stream.
+			template <class S>
+			[[nodiscard]] S& get() { return std::get<S>(this->_streams); }
+
+			/// \copydoc get()
+			template <class S>
+			[[nodiscard]] const S& get() const { return std::get<S>(this->_streams); }
+
+			/// \brief Attempts to get the active stream as the given type.
+			///
+			/// \tparam S The type of the stream to get.
+			/// \return The active stream, or `nullptr` if it is _not_ of the given type.
+			template <class S>
+			[[nodiscard]] S* get_if() noexcept { return std::get_if<S>(&this->_streams); }
+
+			/// \copydoc get_if()
+			template <class S>
+			[[nodiscard]] const S* get_if() const noexcept { return std::get_if<S>(&this->_streams); }
+
+			/// \brief Gets the index of the active stream.
+			///
+			/// \return The zero-based index of the active alternative.
+			[[nodiscard]] std::size_t index() const noexcept { return this->_streams.index(); }
+
+			/// \brief Invokes the given function with the active stream.
+			///
+			/// \param a_func The function to invoke.
+			/// \return The result of the invocation.
+			template <class F>
+			decltype(auto) visit(F&& a_func)
+			{
+				return std::visit(std::forward<F>(a_func), this->_streams);
+			}
+
+			/// \copydoc visit()
+			template <class F>
+			decltype(auto) visit(F&& a_func) const
+			{
+				return std::visit(std::forward<F>(a_func), this->_streams);
+			}
+
+			/// @}
+
+			/// \name Position
+			/// @{
+
+			/// \copydoc binary_io::components::basic_seek_stream::seek_absolute()
+			void seek_absolute(binary_io::streamoff a_pos) noexcept
+			{
+				this->visit([&](auto& a_stream) noexcept { a_stream.seek_absolute(a_pos); });
+			}
+
+			/// \copydoc binary_io::components::basic_seek_stream::seek_relative()
+			void seek_relative(binary_io::streamoff a_off) noexcept
+			{
+				this->visit([&](auto& a_stream) noexcept { a_stream.seek_relative(a_off); });
+			}
+
+			/// \copydoc binary_io::components::basic_seek_stream::tell()
+			[[nodiscard]] binary_io::streamoff tell() const noexcept
+			{
+				return this->visit([](const auto& a_stream) noexcept { return a_stream.tell(); });
+			}
+
+			/// @}
+
+		private:
+			variant_type _streams;
+		};
+	}
+
+	/// \brief A stream which can hold any one of a closed set of other streams.
+	///
+	/// \remark Calls are dispatched to the active stream with `std::visit`, rather than through
+	///		virtual calls. Since a batched \ref istream_interface::read() issues a single
+	///		`read_bytes`, it is dispatched only once.
+	/// \remark When every alternative meets the requirements of
+	///		\ref binary_io::concepts::no_copy_input_stream, so does the variant stream.
+	/// \tparam Streams The stream types which can be held.
+	template <class... Streams>
+	class variant_istream final :
+		public components::variant_stream_base<Streams...>,
+		public binary_io::istream_interface<variant_istream<Streams...>>
+	{
+	private:
+		using super = components::variant_stream_base<Streams...>;
+
+	public:
+		using super::super;
+
+		static_assert(
+			(concepts::input_stream<Streams> && ...),
+			"every alternative must meet the minimum requirements for being an input stream");
+
+		/// \name Reading
+		/// @{
+
+		/// \copydoc span_istream::read_bytes()
+		void read_bytes(std::span<std::byte> a_dst)
+		{
+			this->visit([&](auto& a_stream) { a_stream.read_bytes(a_dst); });
+		}
+
+		/// \copydoc span_istream::read_bytes(std::size_t)
+		[[nodiscard]] auto read_bytes(std::size_t a_count)
+			-> std::span<const std::byte>
+		requires(concepts::no_copy_input_stream<Streams>&&...)
+		{
+			return this->visit([&](auto& a_stream) { return a_stream.read_bytes(a_count); });
+		}
+
+		/// @}
+	};
+
+	/// \copybrief variant_istream
+	///
+	/// \remark Calls are dispatched to the active stream with `std::visit`, rather than through
+	///		virtual calls. Since a batched \ref ostream_interface::write() issues a single
+	///		`write_bytes`, it is dispatched only once.
+	/// \remark When every alternative meets the requirements of
+	///		\ref binary_io::concepts::contiguous_output_stream, so does the variant stream.
+	/// \tparam Streams The stream types which can be held.
+	template <class... Streams>
+	class variant_ostream final :
+		public components::variant_stream_base<Streams...>,
+		public binary_io::ostream_interface<variant_ostream<Streams...>>
+	{
+	private:
+		using super = components::variant_stream_base<Streams...>;
+
+	public:
+		using super::super;
+
+		static_assert(
+			(concepts::output_stream<Streams> && ...),
+			"every alternative must meet the minimum requirements for being an output stream");
+
+		/// \name Writing
+		/// @{
+
+		/// \copydoc span_ostream::write_bytes()
+		void write_bytes(std::span<const std::byte> a_src)
+		{
+			this->visit([&](auto& a_stream) { a_stream.write_bytes(a_src); });
+		}
+
+		/// \copydoc span_ostream::prepare()
+		[[nodiscard]] auto prepare(std::size_t a_count)
+			-> std::span<std::byte>
+		requires(concepts::contiguous_output_stream<Streams>&&...)
+		{
+			return this->visit([&](auto& a_stream) { return a_stream.prepare(a_count); });
+		}
+
+		/// \copydoc span_ostream::commit()
+		void commit(std::size_t a_count) noexcept
+			requires(concepts::contiguous_output_stream<Streams>&&...)
+		{
+			this->visit([&](auto& a_stream) noexcept { a_stream.commit(a_count); });
+		}
+
+		/// @}
+	};
+}
@@ -0,0 +1,219 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+
+#include "binary_io/common.hpp"
+
+namespace binary_io
+{
+#ifndef DOXYGEN
+	namespace detail
+	{
+		struct versioned_record_header
+		{
+			static constexpr std::size_t max_fields = 64;
+
+			[[nodiscard]] static constexpr std::size_t mask_size(std::size_t a_fieldCount) noexcept
+			{
+				return (a_fieldCount + 7) / 8;
+			}
+		};
+	}
+#endif
+
+	/// \brief Writes a record whose fields can be added to over time, without breaking older readers.
+	///
+	/// \remark A record is laid out as a `std::uint8_t` field count, a `std::uint32_t` payload size,
+	///		a presence bitmask with one bit per field, and then the payload, which is the present
+	///		fields in order. Absent fields occupy no space in the payload. Everything is written
+	///		with the stream's default endian format.
+	/// \tparam Stream A stream type derived from \ref binary_io::ostream_interface.
+	template <class Stream>
+	class versioned_record_writer
+	{
+	public:
+		using stream_type = Stream;
+
+		/// \brief Begins a record by writing a placeholder header.
+		///
+		/// \pre `a_fieldCount` _must_ be less than or equal to `64`.
+		/// \param a_out The stream to write the record into. It _must_ outlive the writer.
+		/// \param a_fieldCount The number of fields in the record.
+		versioned_record_writer(
+			stream_type& a_out,
+			std::size_t a_fieldCount) :
+			_out(std::addressof(a_out)),
+			_start(a_out.tell()),
+			_fieldCount(a_fieldCount)
+		{
+			static_assert(concepts::output_stream<stream_type>);
+			assert(a_fieldCount <= header::max_fields);
+
+			std::array<std::byte, header::mask_size(header::max_fields)> mask{};
+			a_out.write(
+				static_cast<std::uint8_t>(a_fieldCount),
+				std::uint32_t{ 0 });
+			a_out.write_bytes(std::span{ mask }.first(header::mask_size(a_fieldCount)));
+			this->_payload = a_out.tell();
+		}
+
+		versioned_record_writer(const versioned_record_writer&) = delete;
+		versioned_record_writer& operator=(const versioned_record_writer&) = delete;
+
+		/// \brief Marks the next field as present or absent.
+		///
+		/// \remark When the field is present, its value _must_ be written directly to the stream
+		///		before the next field is begun.
+		/// \pre Fewer than `a_fieldCount` fields _must_ have been begun.
+		/// \param a_present Whether the field is present.
+		void next_field(bool a_present = true) noexcept
+		{
+			assert(this->_next < this->_fieldCount);
+			if (a_present) {
+				this->_mask |= std::uint64_t{ 1 } << this->_next;
+			}
+			++this->_next;
+		}
+
+		/// \brief Marks the next field as absent. Readers will leave it at its default value.
+		void skip() noexcept { this->next_field(false); }
+
+		/// \brief Writes the next field.
+		///
+		/// \param a_args The values which make up the field.
+		template <class... Args>
+		void write(Args... a_args)
+		{
+			this->next_field(true);
+			this->_out->write(a_args...);
+		}
+
+		/// \brief Ends the record by filling in its header.
+		///
+		/// \remark Fields which were never begun are marked as absent. The stream is left
+		///		positioned at the end of the record.
+		void finish()
+		{
+			const auto end = this->_out->tell();
+			std::array<std::byte, header::mask_size(header::max_fields)> mask{};
+			for (std::size_t i = 0; i < mask.size(); ++i) {
+				mask[i] = static_cast<std::byte>((this->_mask >> (i * 8)) & 0xFF);
+			}
+
+			this->_out->seek_absolute(this->_start + 1);
+			this->_out->write(static_cast<std::uint32_t>(end - this->_payload));
+			this->_out->write_bytes(std::span{ mask }.first(header::mask_size(this->_fieldCount)));
+			this->_out->seek_absolute(end);
+		}
+
+	private:
+		using header = detail::versioned_record_header;
+
+		stream_type* _out{ nullptr };
+		binary_io::streamoff _start{ 0 };
+		binary_io::streamoff _payload{ 0 };
+		std::size_t _fieldCount{ 0 };
+		std::size_t _next{ 0 };
+		std::uint64_t _mask{ 0 };
+	};
+
+	/// \brief Reads a record written by \ref binary_io::versioned_record_writer.
+	///
+	/// \remark Fields the writer marked as absent, or did not know about, are left at their
+	///		current values. Fields the reader does not know about are skipped with a single seek.
+	/// \tparam Stream A stream type derived from \ref binary_io::istream_interface.
+	template <class Stream>
+	class versioned_record_reader
+	{
+	public:
+		using stream_type = Stream;
+
+		/// \brief Begins a record by reading its header.
+		///
+		/// \param a_in The stream to read the record from. It _must_ outlive the reader.
+		explicit versioned_record_reader(stream_type& a_in) :
+			_in(std::addressof(a_in))
+		{
+			static_assert(concepts::input_stream<stream_type>);
+
+			std::uint8_t count = 0;
+			std::uint32_t size = 0;
+			a_in.read(count, size);
+			if (count > header::max_fields) {
+				throw binary_io::exception("versioned record has too many fields");
+			}
+
+			std::array<std::byte, header::mask_size(header::max_fields)> mask{};
+			a_in.read_bytes(std::span{ mask }.first(header::mask_size(count)));
+			for (std::size_t i = 0; i < mask.size(); ++i) {
+				this->_mask |= std::to_integer<std::uint64_t>(mask[i]) << (i * 8);
+			}
+
+			this->_fieldCount = count;
+			this->_end = a_in.tell() + static_cast<binary_io::streamoff>(size);
+		}
+
+		versioned_record_reader(const versioned_record_reader&) = delete;
+		versioned_record_reader& operator=(const versioned_record_reader&) = delete;
+
+		/// \brief Gets the number of fields the writer knew about.
+		///
+		/// \return The writer's field count.
+		[[nodiscard]] std::size_t field_count() const noexcept { return this->_fieldCount; }
+
+		/// \brief Checks if the given field is present in the record.
+		///
+		/// \param a_idx The index of the field.
+		/// \return `true` if the field is present, `false` otherwise.
+		[[nodiscard]] bool has_field(std::size_t a_idx) const noexcept
+		{
+			return a_idx < this->_fieldCount && ((this->_mask >> a_idx) & 1) != 0;
+		}
+
+		/// \brief Begins the next field.
+		///
+		/// \remark When the field is present, its value _must_ be read directly from the stream
+		///		before the next field is begun.
+		/// \return `true` if the field is present, `false` otherwise.
+		[[nodiscard]] bool next_field() noexcept { return this->has_field(this->_next++); }
+
+		/// \brief Reads the next field, if it is present.
+		///
+		/// \param a_args The values which make up the field. They are left unmodified if the
+		///		field is absent.
+		/// \return `true` if the field was present, `false` otherwise.
+		template <class... Args>
+		bool read(Args&... a_args)
+		{
+			if (this->next_field()) {
+				this->_in->read(a_args...);
+				return true;
+			} else {
+				return false;
+			}
+		}
+
+		/// \brief Ends the record by skipping any fields which were not read.
+		///
+		/// \post The stream is positioned at the end of the record.
+		void finish()
+		{
+			if (const auto pos = this->_in->tell(); pos != this->_end) {
+				this->_in->seek_relative(this->_end - pos);
+			}
+		}
+
+	private:
+		using header = detail::versioned_record_header;
+
+		stream_type* _in{ nullptr };
+		binary_io::streamoff _end{ 0 };
+		std::size_t _fieldCount{ 0 };
+		std::size_t _next{ 0 };
+		std::uint64_t _mask{ 0 };
+	};
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <span>
+#include <system_error>
+
+#include "binary_io/common.hpp"
+#include "binary_io/file_stream.hpp"
+#include "binary_io/memory_stream.hpp"
+
+namespace binary_io
+{
+	/// \brief Reads the whole of the file at the given path into memory.
+	///
+	/// \remark The file is opened, sized, and read with a single call each, bypassing stdio.
+	///		If the file shrinks while it is being read, only the bytes which remain are returned.
+	/// \exception std::system_error Thrown when filesystem errors are encountered.
+	/// \param a_path The path to the file to read.
+	/// \return A stream over the contents of the file.
+	[[nodiscard]] binary_io::memory_istream read_file(const std::filesystem::path& a_path);
+
+	/// \copybrief read_file(const std::filesystem::path&)
+	///
+	/// \copydetails read_file(const std::filesystem::path&)
+	/// \pre `a_directory.is_open()` _must_ be `true`.
+	/// \param a_directory The directory to resolve the path from.
+	[[nodiscard]] binary_io::memory_istream read_file(
+		const directory_handle& a_directory,
+		const std::filesystem::path& a_path);
+
+	/// \brief Replaces the contents of the file at the given path with the given bytes.
+	///
+	/// \remark The file is created if it does not exist, and written with a single call,
+	///		bypassing stdio.
+	/// \exception std::system_error Thrown when filesystem errors are encountered.
+	/// \param a_path The path to the file to write.
+	/// \param a_bytes The new contents of the file.
+	void write_file(
+		const std::filesystem::path& a_path,
+		std::span<const std::byte> a_bytes);
+
+	/// \copybrief write_file(const std::filesystem::path&, std::span<const std::byte>)
+	///
+	/// \copydetails write_file(const std::filesystem::path&, std::span<const std::byte>)
+	/// \pre `a_directory.is_open()` _must_ be `true`.
+	/// \param a_directory The directory to resolve the path from.
+	void write_file(
+		const directory_handle& a_directory,
+		const std::filesystem::path& a_path,
+		std::span<const std::byte> a_bytes);
+
+	/// \brief The function \ref read_files() hands each file to.
+	///
+	/// \remark It is invoked with the index of the file's path, the error encountered while
+	///		reading the file (if any), and the contents of the file (which are empty on error).
+	using read_files_callback = std::function<void(
+		std::size_t,
+		std::error_code,
+		binary_io::memory_istream&&)>;
+
+	/// \brief Reads the whole of every file in the given list into memory, many at a time.
+	///
+	/// \remark On Linux, the open, size, read, and close of every file are submitted through
+	///		`io_uring`, so that many files are in flight with few system calls. Elsewhere, or when
+	///		`io_uring` is unavailable, files are read by the threads of \ref default_executor()
+	///		instead.
+	/// \remark The callback is invoked once per file, in completion order rather than list order.
+	///		It is never invoked concurrently, but may be invoked from threads other than the
+	///		calling thread. If it throws, no further files are handed to it, and the exception is
+	///		rethrown once every outstanding read has been drained.
+	/// \exception std::system_error Thrown when the batch itself can not be driven. Errors which
+	///		affect individual files, including running out of memory for their contents, are
+	///		handed to the callback instead.
+	/// \param a_paths The paths to the files to read.
+	/// \param a_callback The function to hand each file to.
+	void read_files(
+		std::span<const std::filesystem::path> a_paths,
+		const read_files_callback& a_callback);
+
+	/// \copybrief read_files(std::span<const std::filesystem::path>, const read_files_callback&)
+	///
+	/// \copydetails read_files(std::span<const std::filesystem::path>, const read_files_callback&)
+	/// \pre `a_directory.is_open()` _must_ be `true`.
+	/// \param a_directory The directory to resolve the paths from.
+	void read_files(
+		const directory_handle& a_directory,
+		std::span<const std::filesystem::path> a_paths,
+		const read_files_callback& a_callback);
+}
@@ -1,15 +1,37 @@
 #include "binary_io/binary_io.hpp"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <condition_variable>
 #include <cassert>
 #include <cerrno>
+#include <climits>
 #include <cstddef>
+#include <cstdint>
 #include <cstdio>
 #include <cstring>
+#include <deque>
+#include <exception>
 #include <filesystem>
+#include <functional>
+#include <initializer_list>
 #include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
 #include <span>
 #include <string>
+#include <string_view>
 #include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if BINARY_IO_ARCH_SSE2
+#	include <emmintrin.h>
+#endif
 
 #if BINARY_IO_OS_WINDOWS
 #	define WIN32_LEAN_AND_MEAN
@@ -55,6 +77,21 @@
 #	define NOMCX
 
 #	include <Windows.h>
+#	include <io.h>
+#else
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/socket.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+
+#	if BINARY_IO_OS_LINUX
+#		include <linux/futex.h>
+#		include <linux/io_uring.h>
+#		include <linux/mempolicy.h>
+#		include <sys/sendfile.h>
+#		include <sys/syscall.h>
+#	endif
 #endif
 
 namespace binary_io
@@ -65,12 +102,12 @@ namespace binary_io
 	{
 		namespace os
 		{
+#if BINARY_IO_OS_WINDOWS
 			[[nodiscard]] auto fopen(
 				const std::filesystem::path::value_type* a_path,
 				const char* a_mode) noexcept
 				-> std::FILE*
 			{
-#if BINARY_IO_OS_WINDOWS
 				std::FILE* result = nullptr;
 
 				// a_mode is basic ASCII which means it's valid utf-16 with a simple cast
@@ -81,10 +118,8 @@ namespace binary_io
 				::SetLastError(ERROR_SUCCESS);
 				(void)::_wfopen_s(&result, a_path, mode.c_str());
 				return result;
-#else
-				return std::fopen(a_path, a_mode);
-#endif
 			}
+#endif
 
 			[[nodiscard]] bool fread(
 				std::span<std::byte> a_dst,
@@ -129,102 +164,225 @@ namespace binary_io
 				return std::ftell(a_stream);
 #endif
 			}
-		}
-	}
-
-	void span_istream::read_bytes(std::span<std::byte> a_dst)
-	{
-		if (a_dst.empty()) {
-			return;
-		}
 
-		const auto count = a_dst.size_bytes();
-		const auto bytes = this->read_bytes(count);
-		std::memcpy(a_dst.data(), bytes.data(), count);
-	}
+			void close_fd(int a_fd) noexcept
+			{
+#if BINARY_IO_OS_WINDOWS
+				::_close(a_fd);
+#else
+				::close(a_fd);
+#endif
+			}
 
-	auto span_istream::read_bytes(std::size_t a_count)
-		-> std::span<const std::byte>
-	{
-		if (a_count == 0) {
-			return {};
-		}
+			// performs a single read, returning the number of bytes read, or 0 at the end of the stream;
+			// `a_what` names the kind of descriptor in error messages
+			[[nodiscard]] std::size_t read_fd(int a_fd, std::span<std::byte> a_dst, const char* a_what)
+			{
+				while (true) {
+#if BINARY_IO_OS_WINDOWS
+					const auto count = static_cast<unsigned>(std::min<std::size_t>(a_dst.size_bytes(), INT_MAX));
+					const auto result = ::_read(a_fd, a_dst.data(), count);
+#else
+					const auto result = ::read(a_fd, a_dst.data(), a_dst.size_bytes());
+#endif
+					if (result >= 0) {
+						return static_cast<std::size_t>(result);
+					} else if (errno != EINTR) {
+						throw std::system_error{ errno, std::generic_category(), std::string{ "failed to read from " } + a_what };
+					}
+				}
+			}
 
-		const auto where = this->tell();
-		assert(where >= 0);
+			void write_fd(int a_fd, std::span<const std::byte> a_src, const char* a_what)
+			{
+				while (!a_src.empty()) {
+#if BINARY_IO_OS_WINDOWS
+					const auto count = static_cast<unsigned>(std::min<std::size_t>(a_src.size_bytes(), INT_MAX));
+					const auto result = ::_write(a_fd, a_src.data(), count);
+#else
+					const auto result = ::write(a_fd, a_src.data(), a_src.size_bytes());
+#endif
+					if (result >= 0) {
+						a_src = a_src.subspan(static_cast<std::size_t>(result));
+					} else if (errno != EINTR) {
+						throw std::system_error{ errno, std::generic_category(), std::string{ "failed to write to " } + a_what };
+					}
+				}
+			}
 
-		const auto buffer = this->rdbuf();
-		if (where + a_count > buffer.size_bytes()) {
-			throw binary_io::buffer_exhausted();
-		}
+			// writes to a socket without raising SIGPIPE when its peer has gone away, and falls
+			// back to a plain write for every other kind of descriptor
+			void send_fd(int a_fd, std::span<const std::byte> a_src, bool& a_socket)
+			{
+#if defined(MSG_NOSIGNAL)
+				while (a_socket && !a_src.empty()) {
+					const auto result = ::send(a_fd, a_src.data(), a_src.size_bytes(), MSG_NOSIGNAL);
+					if (result >= 0) {
+						a_src = a_src.subspan(static_cast<std::size_t>(result));
+					} else if (errno == ENOTSOCK) {
+						a_socket = false;
+					} else if (errno != EINTR) {
+						throw std::system_error{ errno, std::generic_category(), "failed to write to pipe" };
+					}
+				}
+#else
+				a_socket = false;
+#endif
+				write_fd(a_fd, a_src, "pipe");
+			}
 
-		this->seek_relative(static_cast<binary_io::streamoff>(a_count));
-		return {
-			buffer.data() + where,
-			a_count
-		};
-	}
+#if !BINARY_IO_OS_WINDOWS
+			// copies between two files without passing through user space, returning `false`
+			// only if the kernel can't do so for these files before any bytes were copied
+			[[nodiscard]] bool copy_file(
+				int a_in,
+				::off_t& a_inpos,
+				int a_out,
+				::off_t& a_outpos,
+				std::size_t& a_remaining)
+			{
+#	if BINARY_IO_OS_LINUX
+				const auto requested = a_remaining;
+				bool useSendfile = false;
+				while (a_remaining > 0) {
+					::ssize_t copied = 0;
+					if (!useSendfile) {
+						copied = ::copy_file_range(a_in, &a_inpos, a_out, &a_outpos, a_remaining, 0);
+					} else {
+						copied = ::sendfile(a_out, a_in, &a_inpos, a_remaining);
+						if (copied > 0) {
+							a_outpos += copied;
+						}
+					}
 
-	void span_ostream::write_bytes(std::span<const std::byte> a_src)
-	{
-		if (a_src.empty()) {
-			return;
-		}
+					if (copied > 0) {
+						a_remaining -= static_cast<std::size_t>(copied);
+						continue;
+					} else if (copied == 0) {
+						break;
+					}
 
-		const auto where = this->tell();
-		assert(where >= 0);
+					switch (errno) {
+					case EINTR:
+						continue;
+					case EBADF:
+					case EINVAL:
+					case ENOSYS:
+					case EOPNOTSUPP:
+					case EXDEV:
+						// older kernels can't copy across filesystems, but can still send between them
+						if (!useSendfile && ::lseek(a_out, a_outpos, SEEK_SET) != -1) {
+							useSendfile = true;
+							continue;
+						} else if (a_remaining == requested) {
+							return false;
+						}
+						[[fallthrough]];
+					default:
+						throw std::system_error{ errno, std::generic_category(), "failed to copy file" };
+					}
+				}
+				return true;
+#	else
+				(void)a_in;
+				(void)a_inpos;
+				(void)a_out;
+				(void)a_outpos;
+				(void)a_remaining;
+				return false;
+#	endif
+			}
+#endif
 
-		const auto buffer = this->rdbuf();
-		if (where + a_src.size_bytes() > buffer.size_bytes()) {
-			throw binary_io::buffer_exhausted();
-		}
+#if BINARY_IO_OS_LINUX
+			// moves bytes between a pipe and a file without passing through user space: `splice`
+			// out of a pipe when `a_inpos` is null, and `sendfile` out of a file otherwise. returns
+			// `false` only if the kernel can't do so for these descriptors before any bytes moved
+			[[nodiscard]] bool splice_fd(
+				int a_in,
+				::off_t* a_inpos,
+				int a_out,
+				::off_t* a_outpos,
+				std::size_t& a_remaining)
+			{
+				const auto requested = a_remaining;
+				while (a_remaining > 0) {
+					const auto moved =
+						a_inpos == nullptr ?
+							::splice(a_in, nullptr, a_out, a_outpos, a_remaining, SPLICE_F_MOVE) :
+							::sendfile(a_out, a_in, a_inpos, a_remaining);
+					if (moved > 0) {
+						a_remaining -= static_cast<std::size_t>(moved);
+						continue;
+					} else if (moved == 0) {
+						break;
+					}
 
-		this->seek_relative(static_cast<binary_io::streamoff>(a_src.size_bytes()));
-		std::memcpy(
-			buffer.data() + where,
-			a_src.data(),
-			a_src.size_bytes());
-	}
+					switch (errno) {
+					case EINTR:
+						continue;
+					case EBADF:
+					case EINVAL:
+					case ENOSYS:
+					case EOPNOTSUPP:
+						if (a_remaining == requested) {
+							return false;
+						}
+						[[fallthrough]];
+					default:
+						throw std::system_error{ errno, std::generic_category(), "failed to splice pipe" };
+					}
+				}
+				return true;
+			}
 
-	namespace components
-	{
-		void file_stream_base::flush() noexcept
-		{
-			if (this->is_open()) {
-				std::fflush(this->_buffer.get());
+			// the futexes are shared between processes, so they can't use the private variants
+			void futex_wait(std::atomic<std::uint32_t>& a_word, std::uint32_t a_expected) noexcept
+			{
+				::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&a_word), FUTEX_WAIT, a_expected, nullptr, nullptr, 0);
 			}
-		}
 
-		void file_stream_base::seek_absolute(binary_io::streamoff a_pos) noexcept
-		{
-			assert(this->is_open());
-			os::fseek(this->_buffer.get(), a_pos, SEEK_SET);
-		}
+			void futex_wake(std::atomic<std::uint32_t>& a_word) noexcept
+			{
+				::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&a_word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+			}
+#endif
 
-		void file_stream_base::seek_relative(binary_io::streamoff a_off) noexcept
-		{
-			assert(this->is_open());
-			os::fseek(this->_buffer.get(), a_off, SEEK_CUR);
-		}
+			[[noreturn]] void throw_last_error(const char* a_what)
+			{
+#if BINARY_IO_OS_WINDOWS
+				throw std::system_error{
+					static_cast<int>(::GetLastError()),
+					std::system_category(),
+					a_what
+				};
+#else
+				throw std::system_error{ errno, std::generic_category(), a_what };
+#endif
+			}
 
-		auto file_stream_base::tell() const noexcept
-			-> binary_io::streamoff
-		{
-			assert(this->is_open());
-			return os::ftell(this->_buffer.get());
-		}
+#if !BINARY_IO_OS_WINDOWS
+			// opens the file with a single path lookup. fifos would block without O_NONBLOCK, and it
+			// has no effect on regular files
+			[[nodiscard]] int open_fd(
+				const directory_handle* a_directory,
+				const std::filesystem::path& a_path,
+				int a_flags)
+			{
+				const auto fd = ::openat(
+					a_directory != nullptr ? a_directory->native_handle() : AT_FDCWD,
+					a_path.c_str(),
+					a_flags | O_CLOEXEC | O_NONBLOCK,
+					0666);
+				if (fd == -1) {
+					throw_last_error("failed to open file");
+				}
+				return fd;
+			}
 
-		void file_stream_base::open(
-			const std::filesystem::path& a_path,
-			const char* a_mode)
-		{
-			switch (std::filesystem::status(a_path).type()) {
-			case std::filesystem::file_type::not_found:
-			case std::filesystem::file_type::regular:
-				break;
-			case std::filesystem::file_type::none:
-				throw std::system_error{ errno, std::generic_category() };
-			default:
+			[[noreturn]] void throw_irregular(int a_fd)
+			{
+				::close(a_fd);
 				throw std::system_error{
 					ENOENT,
 					std::generic_category(),
@@ -232,63 +390,2417 @@ namespace binary_io
 				};
 			}
 
-			this->_buffer.reset(os::fopen(a_path.c_str(), a_mode));
-			if (this->_buffer == nullptr) {
-				std::string reason = "failed to open file"s;
+			// opens the file and checks what was opened after, rather than stat-ing the path up
+			// front. O_TRUNC is only applied once the file is known to be a regular file
+			[[nodiscard]] int open_regular(
+				const directory_handle* a_directory,
+				const std::filesystem::path& a_path,
+				int a_flags,
+				struct ::stat* a_stat = nullptr)
+			{
+				const auto fd = open_fd(a_directory, a_path, a_flags & ~O_TRUNC);
+
+				struct ::stat st = {};
+				if (::fstat(fd, &st) != 0) {
+					const auto error = errno;
+					::close(fd);
+					throw std::system_error{ error, std::generic_category(), "failed to open file" };
+				} else if (!S_ISREG(st.st_mode)) {
+					throw_irregular(fd);
+				}
+
+				if ((a_flags & O_TRUNC) != 0 && st.st_size != 0) {
+					if (::ftruncate(fd, 0) != 0) {
+						const auto error = errno;
+						::close(fd);
+						throw std::system_error{ error, std::generic_category(), "failed to truncate file" };
+					}
+					st.st_size = 0;
+				}
+
+				if (a_stat != nullptr) {
+					*a_stat = st;
+				}
+				return fd;
+			}
+#endif
 
+			[[nodiscard]] std::size_t page_size() noexcept
+			{
 #if BINARY_IO_OS_WINDOWS
-				if (const auto error = ::GetLastError(); error != ERROR_SUCCESS) {
-					std::unique_ptr<char, decltype(&LocalFree)> dtor{ nullptr, LocalFree };
-					char* buffer = nullptr;
-					if (const auto len = ::FormatMessageA(
-							FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,
+				::SYSTEM_INFO info{};
+				::GetSystemInfo(&info);
+				return info.dwPageSize;
+#else
+				static const auto size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+				return size;
+#endif
+			}
+
+			/// Maps zeroed pages, preferring huge pages. Returns nullptr on failure.
+			[[nodiscard]] std::byte* map_pages(std::size_t a_size, std::size_t a_hugePageSize) noexcept
+			{
+#if BINARY_IO_OS_WINDOWS
+				if (const auto large = ::GetLargePageMinimum();
+					large != 0 && a_size % large == 0) {
+					if (const auto result = ::VirtualAlloc(
 							nullptr,
-							error,
-							0,
-							reinterpret_cast<::LPSTR>(&buffer),
-							0,
-							nullptr);
-						len != 0 && buffer != nullptr) {
-						dtor.reset(buffer);
-						reason.assign(dtor.get(), len);
-						while (!reason.empty() && (reason.ends_with('\r') || reason.ends_with('\n'))) {
-							reason.pop_back();
-						}
+							a_size,
+							MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+							PAGE_READWRITE);
+						result != nullptr) {
+						return static_cast<std::byte*>(result);
 					}
 				}
+
+				return static_cast<std::byte*>(::VirtualAlloc(
+					nullptr,
+					a_size,
+					MEM_RESERVE | MEM_COMMIT,
+					PAGE_READWRITE));
+#else
+#	if BINARY_IO_OS_LINUX
+				if (const auto result = ::mmap(
+						nullptr,
+						a_size,
+						PROT_READ | PROT_WRITE,
+						MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+						-1,
+						0);
+					result != MAP_FAILED) {
+					return static_cast<std::byte*>(result);
+				}
+#	endif
+
+				// over-allocate, so the mapping can be trimmed to start on a huge page boundary
+				const auto padded = a_size + a_hugePageSize;
+				const auto result = ::mmap(
+					nullptr,
+					padded,
+					PROT_READ | PROT_WRITE,
+					MAP_PRIVATE | MAP_ANONYMOUS,
+					-1,
+					0);
+				if (result == MAP_FAILED) {
+					return nullptr;
+				}
+
+				const auto first = reinterpret_cast<std::uintptr_t>(result);
+				const auto aligned = (first + a_hugePageSize - 1) & ~(a_hugePageSize - 1);
+				if (aligned != first) {
+					::munmap(result, aligned - first);
+				}
+				if (const auto tail = first + padded - (aligned + a_size); tail != 0) {
+					::munmap(reinterpret_cast<void*>(aligned + a_size), tail);
+				}
+
+#	if BINARY_IO_OS_LINUX
+				(void)::madvise(reinterpret_cast<void*>(aligned), a_size, MADV_HUGEPAGE);
+#	endif
+				return reinterpret_cast<std::byte*>(aligned);
 #endif
+			}
 
-				throw std::system_error{
-					std::error_code{ errno, std::generic_category() },
-					reason
-				};
+			void unmap_pages(std::byte* a_data, [[maybe_unused]] std::size_t a_size) noexcept
+			{
+#if BINARY_IO_OS_WINDOWS
+				::VirtualFree(a_data, 0, MEM_RELEASE);
+#else
+				::munmap(a_data, a_size);
+#endif
 			}
-		}
-	}
 
-	void file_istream::read_bytes(std::span<std::byte> a_dst)
-	{
-		if (a_dst.empty()) {
-			return;
-		}
+			/// Grows a mapping in place, or by moving its pages. Returns nullptr on failure.
+			[[nodiscard]] std::byte* remap_pages(
+				[[maybe_unused]] std::byte* a_data,
+				[[maybe_unused]] std::size_t a_oldSize,
+				[[maybe_unused]] std::size_t a_newSize) noexcept
+			{
+#if BINARY_IO_OS_LINUX
+				const auto result = ::mremap(a_data, a_oldSize, a_newSize, MREMAP_MAYMOVE);
+				if (result == MAP_FAILED) {
+					return nullptr;
+				}
 
-		if (!os::fread(a_dst, this->_buffer.get())) {
-			throw binary_io::buffer_exhausted();
+				(void)::madvise(result, a_newSize, MADV_HUGEPAGE);
+				return static_cast<std::byte*>(result);
+#else
+				return nullptr;
+#endif
+			}
+
+#if BINARY_IO_OS_LINUX
+			/// A minimal io_uring, driven through the raw system calls.
+			class uring
+			{
+			public:
+				uring() noexcept = default;
+				uring(const uring&) = delete;
+
+				~uring() noexcept { this->close(); }
+
+				uring& operator=(const uring&) = delete;
+
+				/// Returns false if io_uring, or any of the given operations, are unsupported.
+				[[nodiscard]] bool open(
+					unsigned a_entries,
+					std::initializer_list<std::uint8_t> a_operations) noexcept
+				{
+					::io_uring_params params = {};
+					const auto fd = static_cast<int>(::syscall(__NR_io_uring_setup, a_entries, &params));
+					if (fd < 0) {
+						return false;
+					}
+
+					this->_fd = fd;
+					if ((params.features & IORING_FEAT_SINGLE_MMAP) == 0 ||
+						!this->supports(a_operations)) {
+						this->close();
+						return false;
+					}
+
+					this->_ringSize = std::max<std::size_t>(
+						params.sq_off.array + params.sq_entries * sizeof(std::uint32_t),
+						params.cq_off.cqes + params.cq_entries * sizeof(::io_uring_cqe));
+					auto ring = ::mmap(
+						nullptr,
+						this->_ringSize,
+						PROT_READ | PROT_WRITE,
+						MAP_SHARED | MAP_POPULATE,
+						fd,
+						IORING_OFF_SQ_RING);
+					if (ring == MAP_FAILED) {
+						this->close();
+						return false;
+					}
+					this->_ring = static_cast<std::byte*>(ring);
+
+					this->_sqesSize = params.sq_entries * sizeof(::io_uring_sqe);
+					auto sqes = ::mmap(
+						nullptr,
+						this->_sqesSize,
+						PROT_READ | PROT_WRITE,
+						MAP_SHARED | MAP_POPULATE,
+						fd,
+						IORING_OFF_SQES);
+					if (sqes == MAP_FAILED) {
+						this->close();
+						return false;
+					}
+					this->_sqes = static_cast<::io_uring_sqe*>(sqes);
+
+					this->_entries = params.sq_entries;
+					this->_sqTail = this->word(params.sq_off.tail);
+					this->_sqMask = *this->word(params.sq_off.ring_mask);
+					this->_sqArray = reinterpret_cast<std::uint32_t*>(this->_ring + params.sq_off.array);
+					this->_cqHead = this->word(params.cq_off.head);
+					this->_cqTail = this->word(params.cq_off.tail);
+					this->_cqMask = *this->word(params.cq_off.ring_mask);
+					this->_cqes = reinterpret_cast<const ::io_uring_cqe*>(this->_ring + params.cq_off.cqes);
+					this->_tail = this->_sqTail->load(std::memory_order_relaxed);
+					return true;
+				}
+
+				void close() noexcept
+				{
+					if (this->_sqes != nullptr) {
+						::munmap(this->_sqes, this->_sqesSize);
+						this->_sqes = nullptr;
+					}
+					if (this->_ring != nullptr) {
+						::munmap(this->_ring, this->_ringSize);
+						this->_ring = nullptr;
+					}
+					if (this->_fd != -1) {
+						::close(this->_fd);
+						this->_fd = -1;
+					}
+				}
+
+				/// The number of operations which may be in flight at once.
+				[[nodiscard]] std::size_t capacity() const noexcept { return this->_entries; }
+
+				/// Queues an operation, to be submitted by the next call to enter().
+				[[nodiscard]] ::io_uring_sqe& prepare(
+					std::uint8_t a_opcode,
+					std::uint64_t a_userData) noexcept
+				{
+					const auto index = this->_tail++ & this->_sqMask;
+					auto& sqe = this->_sqes[index];
+					sqe = {};
+					sqe.opcode = a_opcode;
+					sqe.user_data = a_userData;
+					this->_sqArray[index] = index;
+					++this->_pending;
+					return sqe;
+				}
+
+				/// Submits every queued operation, and waits until at least one has completed.
+				void enter()
+				{
+					if (!this->try_enter()) {
+						throw_last_error("failed to submit io");
+					}
+				}
+
+				/// As enter(), but returns false, with errno set, rather than throwing.
+				[[nodiscard]] bool try_enter() noexcept
+				{
+					this->_sqTail->store(this->_tail, std::memory_order_release);
+					for (;;) {
+						const auto result = ::syscall(
+							__NR_io_uring_enter,
+							this->_fd,
+							this->_pending,
+							1,
+							IORING_ENTER_GETEVENTS,
+							nullptr,
+							0);
+						if (result >= 0) {
+							this->_pending -= static_cast<std::uint32_t>(result);
+							return true;
+						} else if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+							return false;
+						}
+					}
+				}
+
+				/// Invokes the given function with the user data and result of every completion.
+				template <class F>
+				void complete(F&& a_func) noexcept
+				{
+					auto head = this->_cqHead->load(std::memory_order_relaxed);
+					const auto tail = this->_cqTail->load(std::memory_order_acquire);
+					for (; head != tail; ++head) {
+						const auto cqe = this->_cqes[head & this->_cqMask];
+						this->_cqHead->store(head + 1, std::memory_order_release);
+						a_func(cqe.user_data, cqe.res);
+					}
+				}
+
+			private:
+				using word_type = std::atomic<std::uint32_t>;
+
+				static_assert(word_type::is_always_lock_free);
+				static_assert(sizeof(word_type) == sizeof(std::uint32_t));
+
+				[[nodiscard]] word_type* word(std::uint32_t a_offset) const noexcept
+				{
+					return reinterpret_cast<word_type*>(this->_ring + a_offset);
+				}
+
+				[[nodiscard]] bool supports(std::initializer_list<std::uint8_t> a_operations) const noexcept
+				{
+					constexpr std::size_t count = 256;
+					alignas(::io_uring_probe) std::byte storage[sizeof(::io_uring_probe) + count * sizeof(::io_uring_probe_op)] = {};
+					auto probe = reinterpret_cast<::io_uring_probe*>(storage);
+					if (::syscall(__NR_io_uring_register, this->_fd, IORING_REGISTER_PROBE, probe, count) < 0) {
+						return false;
+					}
+
+					return std::all_of(a_operations.begin(), a_operations.end(), [&](std::uint8_t a_op) {
+						return a_op <= probe->last_op &&
+						       (probe->ops[a_op].flags & IO_URING_OP_SUPPORTED) != 0;
+					});
+				}
+
+				std::byte* _ring{ nullptr };
+				std::size_t _ringSize{ 0 };
+				::io_uring_sqe* _sqes{ nullptr };
+				std::size_t _sqesSize{ 0 };
+				std::uint32_t _entries{ 0 };
+				word_type* _sqTail{ nullptr };
+				std::uint32_t _sqMask{ 0 };
+				std::uint32_t* _sqArray{ nullptr };
+				word_type* _cqHead{ nullptr };
+				word_type* _cqTail{ nullptr };
+				std::uint32_t _cqMask{ 0 };
+				const ::io_uring_cqe* _cqes{ nullptr };
+				std::uint32_t _tail{ 0 };
+				std::uint32_t _pending{ 0 };
+				int _fd{ -1 };
+			};
+#endif
 		}
 	}
 
-	void file_ostream::write_bytes(std::span<const std::byte> a_src)
+	struct work_stealing_executor::state
 	{
-		if (a_src.empty()) {
-			return;
-		}
+		struct queue
+		{
+			std::mutex lock;
+			std::deque<std::function<void()>> tasks;
+		};
 
-		if (std::fwrite(
-				a_src.data(),
-				1,
-				a_src.size_bytes(),
-				this->_buffer.get()) != a_src.size_bytes()) {
-			throw binary_io::buffer_exhausted();
+		[[nodiscard]] std::function<void()> take(std::size_t a_self)
+		{
+			// our own queue is worked most recent first, while others are stolen from oldest first
+			{
+				auto& own = *this->queues[a_self];
+				const std::lock_guard guard{ own.lock };
+				if (!own.tasks.empty()) {
+					auto task = std::move(own.tasks.back());
+					own.tasks.pop_back();
+					return task;
+				}
+			}
+
+			for (std::size_t i = 1; i < this->queues.size(); ++i) {
+				auto& victim = *this->queues[(a_self + i) % this->queues.size()];
+				const std::lock_guard guard{ victim.lock };
+				if (!victim.tasks.empty()) {
+					auto task = std::move(victim.tasks.front());
+					victim.tasks.pop_front();
+					return task;
+				}
+			}
+
+			return nullptr;
+		}
+
+		void work(std::size_t a_self) noexcept
+		{
+			current = this;
+			current_index = a_self;
+
+			for (;;) {
+				if (auto task = this->take(a_self); task) {
+					--this->pending;
+					task();
+					continue;
+				}
+
+				std::unique_lock guard{ this->lock };
+				this->wake.wait(guard, [&]() noexcept {
+					return this->pending > 0 || this->stopping;
+				});
+				if (this->pending == 0 && this->stopping) {
+					return;
+				}
+			}
+		}
+
+		void stop() noexcept
+		{
+			{
+				const std::lock_guard guard{ this->lock };
+				this->stopping = true;
+			}
+			this->wake.notify_all();
+
+			for (auto& thread : this->threads) {
+				thread.join();
+			}
+			this->threads.clear();
+		}
+
+		static inline thread_local const state* current{ nullptr };
+		static inline thread_local std::size_t current_index{ 0 };
+
+		std::vector<std::unique_ptr<queue>> queues;
+		std::vector<std::thread> threads;
+		std::atomic_size_t pending{ 0 };
+		std::atomic_size_t next{ 0 };
+		std::mutex lock;
+		std::condition_variable wake;
+		bool stopping{ false };
+	};
+
+	work_stealing_executor::work_stealing_executor(std::size_t a_threads) :
+		_state(std::make_unique<state>())
+	{
+		const auto count =
+			a_threads != 0 ?
+				a_threads :
+				std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+
+		auto& state = *this->_state;
+		state.queues.reserve(count);
+		for (std::size_t i = 0; i < count; ++i) {
+			state.queues.push_back(std::make_unique<state::queue>());
+		}
+
+		state.threads.reserve(count);
+		try {
+			for (std::size_t i = 0; i < count; ++i) {
+				state.threads.emplace_back(&state::work, &state, i);
+			}
+		} catch (...) {
+			state.stop();
+			throw;
+		}
+	}
+
+	work_stealing_executor::~work_stealing_executor() noexcept
+	{
+		this->_state->stop();
+	}
+
+	void work_stealing_executor::submit(std::function<void()> a_task)
+	{
+		auto& state = *this->_state;
+		const auto index =
+			state::current == &state ?
+				state::current_index :
+				state.next++ % state.queues.size();
+		{
+			auto& queue = *state.queues[index];
+			const std::lock_guard guard{ queue.lock };
+			queue.tasks.push_back(std::move(a_task));
+			++state.pending;
+		}
+
+		// taking the lock orders the increment before any sleeping worker's check
+		{
+			const std::lock_guard guard{ state.lock };
+		}
+		state.wake.notify_one();
+	}
+
+	std::size_t work_stealing_executor::concurrency() const noexcept
+	{
+		return this->_state->queues.size();
+	}
+
+	namespace
+	{
+		std::atomic<executor*> installed_executor{ nullptr };
+	}
+
+	executor& default_executor()
+	{
+		if (const auto installed = installed_executor.load(std::memory_order_acquire);
+			installed != nullptr) {
+			return *installed;
+		}
+
+		static work_stealing_executor builtin;
+		return builtin;
+	}
+
+	void set_default_executor(executor* a_executor) noexcept
+	{
+		installed_executor.store(a_executor, std::memory_order_release);
+	}
+
+	namespace
+	{
+		// Runs a_func(0) through a_func(a_count - 1) on the given executor, with the calling
+		// thread pitching in. Returns once every call has returned. Helpers which only start
+		// after the work has run out touch nothing but the shared state, so they are never waited on.
+		// If the shared state can't be allocated, the calling thread does all of the work itself.
+		template <class F>
+		void run_parallel(
+			executor& a_executor,
+			std::size_t a_count,
+			std::size_t a_concurrency,
+			F&& a_func) noexcept
+		{
+			struct shared
+			{
+				std::atomic_size_t next{ 0 };
+				std::size_t remaining{ 0 };
+				std::mutex lock;
+				std::condition_variable done;
+			};
+
+			std::shared_ptr<shared> state;
+			try {
+				state = std::make_shared<shared>();
+			} catch (...) {
+				for (std::size_t i = 0; i < a_count; ++i) {
+					a_func(i);
+				}
+				return;
+			}
+
+			state->remaining = a_count;
+			const auto func = std::addressof(a_func);
+			const auto count = a_count;
+			const auto work = [state, func, count]() noexcept {
+				for (auto i = state->next++; i < count; i = state->next++) {
+					(*func)(i);
+					const std::lock_guard guard{ state->lock };
+					if (--state->remaining == 0) {
+						state->done.notify_all();
+					}
+				}
+			};
+
+			const auto helpers = std::min(a_count, a_concurrency) - 1;
+			for (std::size_t i = 0; i < helpers; ++i) {
+				try {
+					a_executor.submit(work);
+				} catch (...) {
+					break;
+				}
+			}
+
+			work();
+			std::unique_lock guard{ state->lock };
+			state->done.wait(guard, [&]() noexcept { return state->remaining == 0; });
+		}
+	}
+
+	namespace
+	{
+		constexpr std::size_t min_copy_piece = 1u << 20;
+
+		void stream_bytes(
+			std::byte* a_dst,
+			const std::byte* a_src,
+			std::size_t a_count) noexcept
+		{
+#if BINARY_IO_ARCH_SSE2
+			constexpr std::size_t width = sizeof(::__m128i);
+
+			// align the destination, since streaming stores must be aligned
+			const auto head = std::min(
+				(width - reinterpret_cast<std::uintptr_t>(a_dst) % width) % width,
+				a_count);
+			std::memcpy(a_dst, a_src, head);
+			a_dst += head;
+			a_src += head;
+			a_count -= head;
+
+			for (; a_count >= width * 4; a_count -= width * 4) {
+				const auto src = reinterpret_cast<const ::__m128i*>(a_src);
+				const auto dst = reinterpret_cast<::__m128i*>(a_dst);
+				const auto r0 = ::_mm_loadu_si128(src + 0);
+				const auto r1 = ::_mm_loadu_si128(src + 1);
+				const auto r2 = ::_mm_loadu_si128(src + 2);
+				const auto r3 = ::_mm_loadu_si128(src + 3);
+				::_mm_stream_si128(dst + 0, r0);
+				::_mm_stream_si128(dst + 1, r1);
+				::_mm_stream_si128(dst + 2, r2);
+				::_mm_stream_si128(dst + 3, r3);
+				a_dst += width * 4;
+				a_src += width * 4;
+			}
+
+			std::memcpy(a_dst, a_src, a_count);
+			::_mm_sfence();
+#else
+			std::memcpy(a_dst, a_src, a_count);
+#endif
+		}
+	}
+
+	void copy_bytes(
+		std::span<std::byte> a_dst,
+		std::span<const std::byte> a_src,
+		const copy_policy& a_policy) noexcept
+	{
+		assert(a_dst.size_bytes() >= a_src.size_bytes());
+		if (a_src.empty()) {
+			return;
+		}
+
+		const auto count = a_src.size_bytes();
+		bool bypass = false;
+		switch (a_policy.cache_hint) {
+		case cache_hint::automatic:
+			bypass = count >= a_policy.non_temporal_threshold;
+			break;
+		case cache_hint::temporal:
+			bypass = false;
+			break;
+		case cache_hint::non_temporal:
+			bypass = true;
+			break;
+		default:
+			detail::declare_unreachable();
+		}
+
+		const auto copy = [&](std::size_t a_first, std::size_t a_last) noexcept {
+			if (bypass) {
+				stream_bytes(a_dst.data() + a_first, a_src.data() + a_first, a_last - a_first);
+			} else {
+				std::memcpy(a_dst.data() + a_first, a_src.data() + a_first, a_last - a_first);
+			}
+		};
+
+		if (count < a_policy.parallel_threshold || a_policy.concurrency == 1) {
+			copy(0, count);
+			return;
+		}
+
+		auto& executor = a_policy.executor != nullptr ? *a_policy.executor : default_executor();
+		const auto concurrency =
+			a_policy.concurrency != 0 ?
+				a_policy.concurrency :
+				executor.concurrency() + 1;
+		const auto pieces = std::min(concurrency, count / min_copy_piece);
+		if (pieces <= 1) {
+			copy(0, count);
+			return;
+		}
+
+		// split on the destination's cache line boundaries, so no two threads write to the same
+		// line, while the ends of the copy stay wherever the destination starts and stops
+		constexpr std::size_t line = 64;
+		const auto base = reinterpret_cast<std::uintptr_t>(a_dst.data());
+		const auto boundary = [&](std::size_t a_index) noexcept -> std::size_t {
+			if (a_index == 0) {
+				return 0;
+			} else if (a_index >= pieces) {
+				return count;
+			}
+			const auto at = ((base + a_index * (count / pieces) + line - 1) & ~(line - 1)) - base;
+			return std::min<std::size_t>(at, count);
+		};
+
+		run_parallel(executor, pieces, pieces, [&](std::size_t a_piece) noexcept {
+			copy(boundary(a_piece), boundary(a_piece + 1));
+		});
+	}
+
+	void span_istream::read_bytes(std::span<std::byte> a_dst)
+	{
+		if (a_dst.empty()) {
+			return;
+		}
+
+		const auto bytes = this->read_bytes(a_dst.size_bytes());
+		this->copy_bytes(a_dst, bytes);
+	}
+
+	auto span_istream::read_bytes(std::size_t a_count)
+		-> std::span<const std::byte>
+	{
+		if (a_count == 0) {
+			return {};
+		}
+
+		const auto where = this->tell();
+		assert(where >= 0);
+
+		const auto buffer = this->rdbuf();
+		if (where + a_count > buffer.size_bytes()) {
+			throw binary_io::buffer_exhausted();
+		}
+
+		this->seek_relative(static_cast<binary_io::streamoff>(a_count));
+		return {
+			buffer.data() + where,
+			a_count
+		};
+	}
+
+	void span_ostream::write_bytes(std::span<const std::byte> a_src)
+	{
+		if (a_src.empty()) {
+			return;
+		}
+
+		const auto dst = this->prepare(a_src.size_bytes());
+		this->copy_bytes(dst, a_src);
+		this->commit(a_src.size_bytes());
+	}
+
+	auto span_ostream::prepare(std::size_t a_count)
+		-> std::span<std::byte>
+	{
+		const auto where = this->tell();
+		assert(where >= 0);
+
+		const auto buffer = this->rdbuf();
+		if (where + a_count > buffer.size_bytes()) {
+			throw binary_io::buffer_exhausted();
+		}
+
+		return buffer.subspan(static_cast<std::size_t>(where), a_count);
+	}
+
+	namespace components
+	{
+		void file_stream_base::flush() noexcept
+		{
+			if (this->is_open()) {
+				std::fflush(this->_buffer.get());
+			}
+		}
+
+		void file_stream_base::seek_absolute(binary_io::streamoff a_pos) noexcept
+		{
+			assert(this->is_open());
+			os::fseek(this->_buffer.get(), std::max<binary_io::streamoff>(a_pos, 0), SEEK_SET);
+		}
+
+		void file_stream_base::seek_relative(binary_io::streamoff a_off) noexcept
+		{
+			assert(this->is_open());
+			if (os::fseek(this->_buffer.get(), a_off, SEEK_CUR) != 0 && a_off < 0) {
+				// seeking before the beginning of the file fails, so clamp like every other stream
+				os::fseek(this->_buffer.get(), 0, SEEK_SET);
+			}
+		}
+
+		auto file_stream_base::tell() const noexcept
+			-> binary_io::streamoff
+		{
+			assert(this->is_open());
+			return os::ftell(this->_buffer.get());
+		}
+
+		void file_stream_base::open(
+			const directory_handle* a_directory,
+			const std::filesystem::path& a_path,
+			const char* a_mode)
+		{
+			assert(a_directory == nullptr || a_directory->is_open());
+
+#if BINARY_IO_OS_WINDOWS
+			const auto path = a_directory != nullptr ?
+			                      a_directory->native_handle() / a_path :
+			                      a_path;
+			switch (std::filesystem::status(path).type()) {
+			case std::filesystem::file_type::not_found:
+			case std::filesystem::file_type::regular:
+				break;
+			case std::filesystem::file_type::none:
+				throw std::system_error{ errno, std::generic_category() };
+			default:
+				throw std::system_error{
+					ENOENT,
+					std::generic_category(),
+					"file is not a regular file"
+				};
+			}
+
+			this->_buffer.reset(os::fopen(path.c_str(), a_mode));
+			if (this->_buffer == nullptr) {
+				std::string reason = "failed to open file"s;
+
+				if (const auto error = ::GetLastError(); error != ERROR_SUCCESS) {
+					std::unique_ptr<char, decltype(&LocalFree)> dtor{ nullptr, LocalFree };
+					char* buffer = nullptr;
+					if (const auto len = ::FormatMessageA(
+							FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,
+							nullptr,
+							error,
+							0,
+							reinterpret_cast<::LPSTR>(&buffer),
+							0,
+							nullptr);
+						len != 0 && buffer != nullptr) {
+						dtor.reset(buffer);
+						reason.assign(dtor.get(), len);
+						while (!reason.empty() && (reason.ends_with('\r') || reason.ends_with('\n'))) {
+							reason.pop_back();
+						}
+					}
+				}
+
+				throw std::system_error{
+					std::error_code{ errno, std::generic_category() },
+					reason
+				};
+			}
+#else
+			// every syscall counts when opening many small files. ftruncate fails for anything
+			// but a regular file, so truncating doubles as the check when writing, while reading
+			// and appending check with fstat
+			int fd = -1;
+			switch (a_mode[0]) {
+			case 'r':
+				fd = os::open_regular(a_directory, a_path, O_RDONLY);
+				break;
+			case 'w':
+				fd = os::open_fd(a_directory, a_path, O_WRONLY | O_CREAT);
+				if (::ftruncate(fd, 0) != 0) {
+					if (errno == EINVAL) {
+						os::throw_irregular(fd);
+					}
+					const auto error = errno;
+					::close(fd);
+					throw std::system_error{ error, std::generic_category(), "failed to truncate file" };
+				}
+				break;
+			case 'a':
+				fd = os::open_regular(a_directory, a_path, O_WRONLY | O_CREAT | O_APPEND);
+				break;
+			default:
+				assert(false);
+				break;
+			}
+
+			// stdio would fstat the file for the size of the buffer it allocates, so provide one
+			this->_buffer.reset(::fdopen(fd, a_mode));
+			if (this->_buffer == nullptr) {
+				const auto error = errno;
+				::close(fd);
+				throw std::system_error{ error, std::generic_category(), "failed to open file" };
+			}
+			if (this->_stdio == nullptr) {
+				this->_stdio.reset(new char[stdio_buffer_size]);
+			}
+			(void)std::setvbuf(this->_buffer.get(), this->_stdio.get(), _IOFBF, stdio_buffer_size);
+#endif
+		}
+	}
+
+	void directory_handle::open(const std::filesystem::path& a_path)
+	{
+		this->close();
+
+#if BINARY_IO_OS_WINDOWS
+		if (!std::filesystem::is_directory(a_path)) {
+			throw std::system_error{
+				ENOTDIR,
+				std::generic_category(),
+				"path is not a directory"
+			};
+		}
+		this->_path = a_path;
+#else
+		const auto fd = ::open(a_path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+		if (fd == -1) {
+			os::throw_last_error("failed to open directory");
+		}
+		this->_fd = fd;
+#endif
+	}
+
+	void directory_handle::close() noexcept
+	{
+#if BINARY_IO_OS_WINDOWS
+		this->_path.clear();
+#else
+		if (this->_fd != -1) {
+			::close(std::exchange(this->_fd, -1));
+		}
+#endif
+	}
+
+	namespace components
+	{
+		void pipe_stream_base::close() noexcept
+		{
+			if (this->is_open()) {
+				os::close_fd(this->release());
+			}
+		}
+	}
+
+	bool pipe_istream::at_end()
+	{
+		assert(this->is_open());
+		if (this->_first == this->_last) {
+			this->_first = 0;
+			this->_last = this->fill({ this->_buffer.get(), this->_capacity });
+		}
+		return this->_first == this->_last;
+	}
+
+	void pipe_istream::read_bytes(std::span<std::byte> a_dst)
+	{
+		assert(this->is_open());
+		while (!a_dst.empty()) {
+			if (this->_first == this->_last) {
+				if (a_dst.size_bytes() >= this->_capacity) {
+					// buffering would only add a copy
+					const auto count = this->fill(a_dst);
+					if (count == 0) {
+						throw binary_io::buffer_exhausted();
+					}
+					this->_pos += static_cast<binary_io::streamoff>(count);
+					a_dst = a_dst.subspan(count);
+					continue;
+				} else if (this->at_end()) {
+					throw binary_io::buffer_exhausted();
+				}
+			}
+
+			const auto count = std::min(a_dst.size_bytes(), this->_last - this->_first);
+			std::memcpy(a_dst.data(), this->_buffer.get() + this->_first, count);
+			this->_first += count;
+			this->_pos += static_cast<binary_io::streamoff>(count);
+			a_dst = a_dst.subspan(count);
+		}
+	}
+
+	std::size_t pipe_istream::fill(std::span<std::byte> a_dst)
+	{
+		return os::read_fd(this->native_handle(), a_dst, "pipe");
+	}
+
+	void pipe_ostream::flush()
+	{
+		if (this->is_open() && this->_size > 0) {
+			// drop the buffer first, so a failed flush isn't retried by close
+			const auto size = std::exchange(this->_size, 0);
+			os::send_fd(this->native_handle(), { this->_buffer.get(), size }, this->_socket);
+		}
+	}
+
+	void pipe_ostream::close() noexcept
+	{
+		try {
+			this->flush();
+		} catch (const std::system_error&) {}
+		super::close();
+	}
+
+	void pipe_ostream::write_bytes(std::span<const std::byte> a_src)
+	{
+		assert(this->is_open());
+		if (a_src.empty()) {
+			return;
+		}
+
+		if (this->_size + a_src.size_bytes() > this->_capacity) {
+			this->flush();
+		}
+
+		if (a_src.size_bytes() >= this->_capacity) {
+			os::send_fd(this->native_handle(), a_src, this->_socket);
+		} else {
+			std::memcpy(this->_buffer.get() + this->_size, a_src.data(), a_src.size_bytes());
+			this->_size += a_src.size_bytes();
+		}
+		this->_pos += static_cast<binary_io::streamoff>(a_src.size_bytes());
+	}
+
+#if BINARY_IO_OS_LINUX
+	namespace
+	{
+		// lives in the first page of the shared memory, followed by the ring's data
+		struct ring_control
+		{
+			static constexpr std::uint64_t signature = 0x676E69526F69426Eull;
+			static constexpr std::uint32_t layout_version = 1;
+
+			static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+			static_assert(std::atomic<std::uint32_t>::is_always_lock_free);
+			static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t));
+
+			// written by the producer
+			alignas(64) std::atomic<std::uint64_t> head{ 0 };
+			std::atomic<std::uint32_t> headSeq{ 0 };
+			std::atomic<std::uint32_t> producerClosed{ 0 };
+			std::atomic<std::uint32_t> producerWaiting{ 0 };
+
+			// written by the consumer
+			alignas(64) std::atomic<std::uint64_t> tail{ 0 };
+			std::atomic<std::uint32_t> tailSeq{ 0 };
+			std::atomic<std::uint32_t> consumerClosed{ 0 };
+			std::atomic<std::uint32_t> consumerWaiting{ 0 };
+
+			alignas(64) std::uint64_t magic{ signature };
+			std::uint32_t version{ layout_version };
+		};
+
+		[[nodiscard]] ring_control& control(void* a_control) noexcept
+		{
+			return *static_cast<ring_control*>(a_control);
+		}
+
+		// bumps the sequence the other end may be sleeping on, and wakes it if it is
+		void ring_notify(
+			std::atomic<std::uint32_t>& a_seq,
+			const std::atomic<std::uint32_t>& a_waiting,
+			bool a_force = false) noexcept
+		{
+			if (a_force || a_waiting.load() != 0) {
+				a_seq.fetch_add(1);
+				os::futex_wake(a_seq);
+			}
+		}
+
+		// sleeps until `a_ready` is satisfied, or the other end notifies us
+		template <class F>
+		void ring_wait(
+			std::atomic<std::uint32_t>& a_seq,
+			std::atomic<std::uint32_t>& a_waiting,
+			F a_ready) noexcept
+		{
+			const auto seq = a_seq.load();
+			a_waiting.store(1);
+			if (!a_ready()) {
+				os::futex_wait(a_seq, seq);
+			}
+			a_waiting.store(0);
+		}
+	}
+
+	namespace components
+	{
+		void ring_stream_base::create(std::size_t a_capacity)
+		{
+			this->close();
+
+			const auto page = os::page_size();
+			const auto capacity = (std::max<std::size_t>(a_capacity, 1) + page - 1) / page * page;
+			const auto fd = ::memfd_create("binary_io_ring", MFD_CLOEXEC);
+			if (fd == -1) {
+				os::throw_last_error("failed to create shared memory");
+			}
+			const auto fail = [&](const char* a_what) {
+				const auto error = errno;
+				::close(fd);
+				throw std::system_error{ error, std::generic_category(), a_what };
+			};
+
+			if (::ftruncate(fd, static_cast<::off_t>(page + capacity)) != 0) {
+				fail("failed to size shared memory");
+			}
+
+			// stamp the control page before attaching, which checks for the stamp
+			const auto control = ::mmap(nullptr, page, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+			if (control == MAP_FAILED) {
+				fail("failed to map shared memory");
+			}
+			new (control) ring_control{};
+			::munmap(control, page);
+
+			this->open(fd);
+		}
+
+		void ring_stream_base::open(int a_fd)
+		{
+			this->close();
+
+			const auto fail = [&](const char* a_what, int a_error) {
+				this->close();
+				::close(a_fd);
+				throw std::system_error{ a_error, std::generic_category(), a_what };
+			};
+
+			const auto page = os::page_size();
+			struct ::stat st = {};
+			if (::fstat(a_fd, &st) != 0) {
+				fail("failed to get shared memory size", errno);
+			} else if (static_cast<std::size_t>(st.st_size) <= page ||
+					   static_cast<std::size_t>(st.st_size) % page != 0) {
+				fail("file descriptor is not a ring", EINVAL);
+			}
+			const auto capacity = static_cast<std::size_t>(st.st_size) - page;
+
+			const auto control = ::mmap(nullptr, page, PROT_READ | PROT_WRITE, MAP_SHARED, a_fd, 0);
+			if (control == MAP_FAILED) {
+				fail("failed to map shared memory", errno);
+			}
+			this->_control = control;
+			if (const auto& ctl = binary_io::control(control);
+				ctl.magic != ring_control::signature ||
+				ctl.version != ring_control::layout_version) {
+				fail("file descriptor is not a ring", EINVAL);
+			}
+
+			// map the data twice, back to back, so windows which wrap around are still contiguous
+			const auto reserved = ::mmap(nullptr, capacity * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (reserved == MAP_FAILED) {
+				fail("failed to reserve address space", errno);
+			}
+			this->_data = static_cast<std::byte*>(reserved);
+			this->_capacity = capacity;
+			for (std::size_t i = 0; i < 2; ++i) {
+				if (::mmap(
+						this->_data + capacity * i,
+						capacity,
+						PROT_READ | PROT_WRITE,
+						MAP_SHARED | MAP_FIXED,
+						a_fd,
+						static_cast<::off_t>(page)) == MAP_FAILED) {
+					fail("failed to map shared memory", errno);
+				}
+			}
+
+			this->_fd = a_fd;
+		}
+
+		void ring_stream_base::close() noexcept
+		{
+			if (this->_data != nullptr) {
+				::munmap(this->_data, this->_capacity * 2);
+				this->_data = nullptr;
+				this->_capacity = 0;
+			}
+			if (this->_control != nullptr) {
+				::munmap(this->_control, os::page_size());
+				this->_control = nullptr;
+			}
+			if (this->_fd != -1) {
+				::close(std::exchange(this->_fd, -1));
+			}
+		}
+	}
+
+	void ring_istream::close() noexcept
+	{
+		if (this->is_open()) {
+			auto& ctl = control(this->_control);
+			ctl.consumerClosed.store(1);
+			ring_notify(ctl.tailSeq, ctl.producerWaiting, true);
+		}
+		super::close();
+	}
+
+	auto ring_istream::tell() const noexcept
+		-> binary_io::streamoff
+	{
+		assert(this->is_open());
+		return static_cast<binary_io::streamoff>(control(this->_control).tail.load(std::memory_order_relaxed));
+	}
+
+	bool ring_istream::at_end()
+	{
+		assert(this->is_open());
+		auto& ctl = control(this->_control);
+		const auto tail = ctl.tail.load(std::memory_order_relaxed);
+		const auto ready = [&]() noexcept {
+			return ctl.head.load() != tail || ctl.producerClosed.load() != 0;
+		};
+		while (!ready()) {
+			ring_wait(ctl.headSeq, ctl.consumerWaiting, ready);
+		}
+		return ctl.head.load() == tail;
+	}
+
+	void ring_istream::read_bytes(std::span<std::byte> a_dst)
+	{
+		assert(this->is_open());
+		auto& ctl = control(this->_control);
+		while (!a_dst.empty()) {
+			if (this->at_end()) {
+				throw binary_io::buffer_exhausted();
+			}
+
+			const auto tail = ctl.tail.load(std::memory_order_relaxed);
+			const auto available = static_cast<std::size_t>(ctl.head.load(std::memory_order_acquire) - tail);
+			const auto count = std::min(available, a_dst.size_bytes());
+			std::memcpy(a_dst.data(), this->_data + tail % this->_capacity, count);
+			a_dst = a_dst.subspan(count);
+
+			ctl.tail.store(tail + count);
+			ring_notify(ctl.tailSeq, ctl.producerWaiting);
+		}
+	}
+
+	void ring_ostream::close() noexcept
+	{
+		if (this->is_open()) {
+			auto& ctl = control(this->_control);
+			ctl.producerClosed.store(1);
+			ring_notify(ctl.headSeq, ctl.consumerWaiting, true);
+		}
+		super::close();
+	}
+
+	auto ring_ostream::tell() const noexcept
+		-> binary_io::streamoff
+	{
+		assert(this->is_open());
+		return static_cast<binary_io::streamoff>(control(this->_control).head.load(std::memory_order_relaxed));
+	}
+
+	auto ring_ostream::prepare(std::size_t a_count)
+		-> std::span<std::byte>
+	{
+		assert(this->is_open());
+		if (a_count > this->_capacity) {
+			throw binary_io::buffer_exhausted();
+		}
+
+		this->wait_for_room(a_count);
+		const auto head = control(this->_control).head.load(std::memory_order_relaxed);
+		return { this->_data + head % this->_capacity, a_count };
+	}
+
+	void ring_ostream::commit(std::size_t a_count) noexcept
+	{
+		assert(this->is_open());
+		auto& ctl = control(this->_control);
+		ctl.head.store(ctl.head.load(std::memory_order_relaxed) + a_count);
+		ring_notify(ctl.headSeq, ctl.consumerWaiting);
+	}
+
+	void ring_ostream::write_bytes(std::span<const std::byte> a_src)
+	{
+		assert(this->is_open());
+		while (!a_src.empty()) {
+			// fill whatever room there is, rather than waiting for the whole write to fit
+			const auto count = std::min(this->wait_for_room(1), a_src.size_bytes());
+			const auto dst = this->prepare(count);
+			std::memcpy(dst.data(), a_src.data(), count);
+			this->commit(count);
+			a_src = a_src.subspan(count);
+		}
+	}
+
+	std::size_t ring_ostream::wait_for_room(std::size_t a_count)
+	{
+		auto& ctl = control(this->_control);
+		const auto head = ctl.head.load(std::memory_order_relaxed);
+		const auto room = [&]() noexcept {
+			return this->_capacity - static_cast<std::size_t>(head - ctl.tail.load());
+		};
+		const auto ready = [&]() noexcept {
+			return room() >= a_count || ctl.consumerClosed.load() != 0;
+		};
+		while (!ready()) {
+			ring_wait(ctl.tailSeq, ctl.producerWaiting, ready);
+		}
+
+		if (ctl.consumerClosed.load() != 0) {
+			throw std::system_error{ EPIPE, std::generic_category(), "ring consumer has detached" };
+		}
+		return room();
+	}
+#endif
+
+	namespace
+	{
+		[[nodiscard]] binary_io::memory_istream read_file(
+			const directory_handle* a_directory,
+			const std::filesystem::path& a_path)
+		{
+			binary_io::memory_istream::container_type buffer;
+#if BINARY_IO_OS_WINDOWS
+			const auto path = a_directory != nullptr ?
+			                      a_directory->native_handle() / a_path :
+			                      a_path;
+			const auto file = ::CreateFileW(
+				path.c_str(),
+				GENERIC_READ,
+				FILE_SHARE_READ,
+				nullptr,
+				OPEN_EXISTING,
+				FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+				nullptr);
+			if (file == INVALID_HANDLE_VALUE) {
+				os::throw_last_error("failed to open file");
+			}
+
+			try {
+				::LARGE_INTEGER size{};
+				if (::GetFileSizeEx(file, &size) == 0) {
+					os::throw_last_error("failed to get file size");
+				}
+
+				buffer.resize(static_cast<std::size_t>(size.QuadPart), binary_io::default_init);
+				std::size_t total = 0;
+				while (total < buffer.size()) {
+					::DWORD count = 0;
+					const auto want = static_cast<::DWORD>(std::min<std::size_t>(buffer.size() - total, MAXDWORD));
+					if (::ReadFile(file, buffer.data() + total, want, &count, nullptr) == 0) {
+						os::throw_last_error("failed to read from file");
+					} else if (count == 0) {
+						break;
+					}
+					total += count;
+				}
+				buffer.resize(total);
+			} catch (...) {
+				::CloseHandle(file);
+				throw;
+			}
+			::CloseHandle(file);
+#else
+			struct ::stat st = {};
+			const auto fd = os::open_regular(a_directory, a_path, O_RDONLY, &st);
+			try {
+				buffer.resize(static_cast<std::size_t>(st.st_size), binary_io::default_init);
+				std::size_t total = 0;
+				while (total < buffer.size()) {
+					const auto count = os::read_fd(fd, std::span{ buffer }.subspan(total), "file");
+					if (count == 0) {
+						break;
+					}
+					total += count;
+				}
+				buffer.resize(total);
+			} catch (...) {
+				::close(fd);
+				throw;
+			}
+			::close(fd);
+#endif
+			return binary_io::memory_istream{ std::move(buffer) };
+		}
+
+		void write_file(
+			const directory_handle* a_directory,
+			const std::filesystem::path& a_path,
+			std::span<const std::byte> a_bytes)
+		{
+#if BINARY_IO_OS_WINDOWS
+			const auto path = a_directory != nullptr ?
+			                      a_directory->native_handle() / a_path :
+			                      a_path;
+			const auto file = ::CreateFileW(
+				path.c_str(),
+				GENERIC_WRITE,
+				0,
+				nullptr,
+				CREATE_ALWAYS,
+				FILE_ATTRIBUTE_NORMAL,
+				nullptr);
+			if (file == INVALID_HANDLE_VALUE) {
+				os::throw_last_error("failed to open file");
+			}
+
+			try {
+				while (!a_bytes.empty()) {
+					::DWORD count = 0;
+					const auto want = static_cast<::DWORD>(std::min<std::size_t>(a_bytes.size(), MAXDWORD));
+					if (::WriteFile(file, a_bytes.data(), want, &count, nullptr) == 0) {
+						os::throw_last_error("failed to write to file");
+					}
+					a_bytes = a_bytes.subspan(count);
+				}
+			} catch (...) {
+				::CloseHandle(file);
+				throw;
+			}
+			::CloseHandle(file);
+#else
+			const auto fd = os::open_regular(a_directory, a_path, O_WRONLY | O_CREAT | O_TRUNC);
+			try {
+				os::write_fd(fd, a_bytes, "file");
+			} catch (...) {
+				::close(fd);
+				throw;
+			}
+			::close(fd);
+#endif
+		}
+	}
+
+	namespace
+	{
+		// Files are read through io_uring in batches of this size.
+		constexpr std::size_t read_files_depth = 64;
+
+		void read_files_threaded(
+			const directory_handle* a_directory,
+			std::span<const std::filesystem::path> a_paths,
+			const read_files_callback& a_callback)
+		{
+			std::mutex lock;
+			std::exception_ptr failure;
+			std::atomic_bool failed = false;
+
+			auto& executor = default_executor();
+			const auto concurrency = std::min(a_paths.size(), executor.concurrency() + 1);
+			run_parallel(executor, a_paths.size(), concurrency, [&](std::size_t a_index) noexcept {
+				if (failed) {
+					return;
+				}
+
+				std::error_code error;
+				binary_io::memory_istream contents;
+				try {
+					contents = read_file(a_directory, a_paths[a_index]);
+				} catch (const std::system_error& a_err) {
+					error = a_err.code();
+				} catch (const std::bad_alloc&) {
+					error = std::make_error_code(std::errc::not_enough_memory);
+				} catch (...) {
+					const std::lock_guard guard{ lock };
+					if (!failure) {
+						failure = std::current_exception();
+						failed = true;
+					}
+					return;
+				}
+
+				const std::lock_guard guard{ lock };
+				if (failure) {
+					return;
+				}
+
+				try {
+					a_callback(a_index, error, std::move(contents));
+				} catch (...) {
+					failure = std::current_exception();
+					failed = true;
+				}
+			});
+
+			if (failure) {
+				std::rethrow_exception(failure);
+			}
+		}
+
+#if BINARY_IO_OS_LINUX
+		/// Returns false if io_uring is unavailable, before any file is read.
+		[[nodiscard]] bool read_files_uring(
+			const directory_handle* a_directory,
+			std::span<const std::filesystem::path> a_paths,
+			const read_files_callback& a_callback)
+		{
+			os::uring ring;
+			if (!ring.open(
+					read_files_depth * 4,
+					{ IORING_OP_OPENAT, IORING_OP_STATX, IORING_OP_READ, IORING_OP_CLOSE })) {
+				return false;
+			}
+
+			// user data is the job's slot, shifted over to make room for the operation
+			enum : std::uint64_t
+			{
+				op_open,
+				op_stat,
+				op_read,
+				op_close,
+
+				op_bits = 2,
+				op_mask = (1u << op_bits) - 1
+			};
+
+			struct job
+			{
+				std::size_t index{ 0 };
+				int fd{ -1 };
+				int error{ 0 };
+				struct ::statx stat = {};
+				binary_io::memory_istream::container_type buffer;
+				std::size_t done{ 0 };
+			};
+
+			// the kernel writes into the jobs, so they must outlive every operation in flight
+			const auto dirfd = a_directory != nullptr ? a_directory->native_handle() : AT_FDCWD;
+			const auto depth = std::min(read_files_depth, a_paths.size());
+			auto jobs = std::make_unique<job[]>(depth);
+			std::vector<std::size_t> idle(depth);
+			for (std::size_t i = 0; i < idle.size(); ++i) {
+				idle[i] = idle.size() - i - 1;
+			}
+
+			std::size_t next = 0;
+			std::size_t inflight = 0;
+			std::exception_ptr failure;
+
+			const auto submit = [&](std::uint8_t a_opcode, std::size_t a_slot, std::uint64_t a_op) -> ::io_uring_sqe& {
+				++inflight;
+				return ring.prepare(a_opcode, (static_cast<std::uint64_t>(a_slot) << op_bits) | a_op);
+			};
+
+			const auto read = [&](std::size_t a_slot) {
+				auto& job = jobs[a_slot];
+				auto& sqe = submit(IORING_OP_READ, a_slot, op_read);
+				sqe.fd = job.fd;
+				sqe.addr = reinterpret_cast<std::uintptr_t>(job.buffer.data() + job.done);
+				sqe.len = static_cast<std::uint32_t>(std::min<std::size_t>(job.buffer.size() - job.done, INT_MAX));
+				sqe.off = job.done;
+			};
+
+			const auto finish = [&](std::size_t a_slot) noexcept {
+				auto& job = jobs[a_slot];
+				if (job.fd != -1) {
+					auto& sqe = submit(IORING_OP_CLOSE, a_slot, op_close);
+					sqe.fd = job.fd;
+					job.fd = -1;
+				}
+
+				std::error_code error;
+				if (job.error != 0) {
+					error = std::error_code{ job.error, std::generic_category() };
+					job.buffer.clear();
+				} else {
+					job.buffer.resize(job.done);
+				}
+
+				if (!failure) {
+					try {
+						a_callback(
+							job.index,
+							error,
+							binary_io::memory_istream{ std::move(job.buffer) });
+					} catch (...) {
+						failure = std::current_exception();
+						next = a_paths.size();
+					}
+				}
+
+				job.buffer = {};
+				idle.push_back(a_slot);
+			};
+
+			const auto start = [&](std::size_t a_slot) {
+				auto& job = jobs[a_slot];
+				job.index = next++;
+				job.error = 0;
+				job.done = 0;
+
+				auto& open = submit(IORING_OP_OPENAT, a_slot, op_open);
+				open.fd = dirfd;
+				open.addr = reinterpret_cast<std::uintptr_t>(a_paths[job.index].c_str());
+				open.open_flags = O_RDONLY | O_CLOEXEC | O_NONBLOCK;
+			};
+
+			// the descriptor is stat'd rather than the path, so that the size and type belong to
+			// the file that was actually opened
+			const auto stat = [&](std::size_t a_slot) {
+				auto& job = jobs[a_slot];
+				auto& sqe = submit(IORING_OP_STATX, a_slot, op_stat);
+				sqe.fd = job.fd;
+				sqe.addr = reinterpret_cast<std::uintptr_t>("");
+				sqe.len = STATX_TYPE | STATX_SIZE;
+				sqe.off = reinterpret_cast<std::uintptr_t>(&job.stat);
+				sqe.statx_flags = AT_EMPTY_PATH;
+			};
+
+			const auto complete = [&](std::uint64_t a_userData, std::int32_t a_result) noexcept {
+				--inflight;
+				const auto op = a_userData & op_mask;
+				const auto slot = static_cast<std::size_t>(a_userData >> op_bits);
+				if (op == op_close) {
+					return;
+				}
+
+				auto& job = jobs[slot];
+				if (a_result < 0 && job.error == 0) {
+					job.error = -a_result;
+				}
+
+				switch (op) {
+				case op_open:
+					if (a_result >= 0) {
+						job.fd = a_result;
+						stat(slot);
+						return;
+					}
+					break;
+				case op_stat:
+					if (job.error == 0 && !S_ISREG(job.stat.stx_mode)) {
+						job.error = ENOENT;
+					}
+
+					if (job.error == 0) {
+						try {
+							job.buffer.resize(static_cast<std::size_t>(job.stat.stx_size), binary_io::default_init);
+						} catch (const std::bad_alloc&) {
+							job.error = ENOMEM;
+						}
+					}
+					break;
+				case op_read:
+					if (a_result > 0) {
+						job.done += static_cast<std::size_t>(a_result);
+					} else if (a_result == 0) {
+						job.buffer.resize(job.done);
+					} else if (a_result == -EINTR || a_result == -EAGAIN) {
+						job.error = 0;
+					}
+					break;
+				default:
+					detail::declare_unreachable();
+				}
+
+				if (job.error == 0 && job.done < job.buffer.size()) {
+					read(slot);
+				} else {
+					finish(slot);
+				}
+			};
+
+			// reaps every operation still in flight without starting new ones, then closes the
+			// descriptors which were opened along the way
+			const auto drain = [&]() noexcept {
+				const auto reap = [&](std::uint64_t a_userData, std::int32_t a_result) noexcept {
+					--inflight;
+					if ((a_userData & op_mask) == op_open && a_result >= 0) {
+						jobs[static_cast<std::size_t>(a_userData >> op_bits)].fd = a_result;
+					}
+				};
+
+				while (inflight > 0) {
+					if (!ring.try_enter()) {
+						// the ring can't be waited on, so the kernel may still write into the jobs
+						// after this returns. leak them rather than free memory which is in use
+						(void)jobs.release();
+						return;
+					}
+					ring.complete(reap);
+				}
+
+				for (std::size_t i = 0; i < depth; ++i) {
+					if (jobs[i].fd != -1) {
+						::close(jobs[i].fd);
+					}
+				}
+			};
+
+			// every job holds at most 1 operation in flight, plus the close of its predecessor
+			try {
+				while (next < a_paths.size() || idle.size() < depth || inflight > 0) {
+					while (next < a_paths.size() && !idle.empty() && inflight + 2 <= ring.capacity()) {
+						const auto slot = idle.back();
+						idle.pop_back();
+						start(slot);
+					}
+
+					ring.enter();
+					ring.complete(complete);
+				}
+			} catch (...) {
+				drain();
+				throw;
+			}
+
+			if (failure) {
+				std::rethrow_exception(failure);
+			}
+			return true;
+		}
+#endif
+
+		void read_files(
+			const directory_handle* a_directory,
+			std::span<const std::filesystem::path> a_paths,
+			const read_files_callback& a_callback)
+		{
+			if (a_paths.empty()) {
+				return;
+			}
+
+#if BINARY_IO_OS_LINUX
+			if (read_files_uring(a_directory, a_paths, a_callback)) {
+				return;
+			}
+#endif
+			read_files_threaded(a_directory, a_paths, a_callback);
+		}
+	}
+
+	binary_io::memory_istream read_file(const std::filesystem::path& a_path)
+	{
+		return read_file(nullptr, a_path);
+	}
+
+	binary_io::memory_istream read_file(
+		const directory_handle& a_directory,
+		const std::filesystem::path& a_path)
+	{
+		assert(a_directory.is_open());
+		return read_file(std::addressof(a_directory), a_path);
+	}
+
+	void write_file(
+		const std::filesystem::path& a_path,
+		std::span<const std::byte> a_bytes)
+	{
+		write_file(nullptr, a_path, a_bytes);
+	}
+
+	void write_file(
+		const directory_handle& a_directory,
+		const std::filesystem::path& a_path,
+		std::span<const std::byte> a_bytes)
+	{
+		assert(a_directory.is_open());
+		write_file(std::addressof(a_directory), a_path, a_bytes);
+	}
+
+	void read_files(
+		std::span<const std::filesystem::path> a_paths,
+		const read_files_callback& a_callback)
+	{
+		read_files(nullptr, a_paths, a_callback);
+	}
+
+	void read_files(
+		const directory_handle& a_directory,
+		std::span<const std::filesystem::path> a_paths,
+		const read_files_callback& a_callback)
+	{
+		assert(a_directory.is_open());
+		read_files(std::addressof(a_directory), a_paths, a_callback);
+	}
+
+	void file_istream::read_bytes(std::span<std::byte> a_dst)
+	{
+		if (a_dst.empty()) {
+			return;
+		}
+
+		if (!os::fread(a_dst, this->_buffer.get())) {
+			throw binary_io::buffer_exhausted();
+		}
+	}
+
+	void file_ostream::write_bytes(std::span<const std::byte> a_src)
+	{
+		if (a_src.empty()) {
+			return;
+		}
+
+		if (std::fwrite(
+				a_src.data(),
+				1,
+				a_src.size_bytes(),
+				this->_buffer.get()) != a_src.size_bytes()) {
+			throw binary_io::buffer_exhausted();
+		}
+	}
+
+	void copy(file_istream& a_in, file_ostream& a_out, std::size_t a_count)
+	{
+		assert(a_in.is_open() && a_out.is_open());
+		if (a_count == 0) {
+			return;
+		}
+
+#if !BINARY_IO_OS_WINDOWS
+		// the kernel copies between the files themselves, so pending writes must land first
+		a_out.flush();
+
+		auto inpos = static_cast<::off_t>(a_in.tell());
+		auto outpos = static_cast<::off_t>(a_out.tell());
+		auto remaining = a_count;
+		if (os::copy_file(
+				::fileno(a_in.rdbuf()),
+				inpos,
+				::fileno(a_out.rdbuf()),
+				outpos,
+				remaining)) {
+			// resynchronize the stdio buffers with the file offsets
+			a_in.seek_absolute(inpos);
+			a_out.seek_absolute(outpos);
+			if (remaining > 0) {
+				throw binary_io::buffer_exhausted();
+			}
+			return;
+		}
+#endif
+
+		detail::copy_buffered(a_in, a_out, a_count);
+	}
+
+	void copy(pipe_istream& a_in, file_ostream& a_out, std::size_t a_count)
+	{
+		assert(a_in.is_open() && a_out.is_open());
+
+		// bytes which have already been pulled out of the pipe go first
+		const auto buffered = std::min(a_count, a_in._last - a_in._first);
+		if (buffered > 0) {
+			a_out.write_bytes({ a_in._buffer.get() + a_in._first, buffered });
+			a_in._first += buffered;
+			a_in._pos += static_cast<binary_io::streamoff>(buffered);
+			a_count -= buffered;
+		}
+		if (a_count == 0) {
+			return;
+		}
+
+#if BINARY_IO_OS_LINUX
+		a_out.flush();
+
+		auto outpos = static_cast<::off_t>(a_out.tell());
+		auto remaining = a_count;
+		if (os::splice_fd(
+				a_in.native_handle(),
+				nullptr,
+				::fileno(a_out.rdbuf()),
+				&outpos,
+				remaining)) {
+			a_in._pos += static_cast<binary_io::streamoff>(a_count - remaining);
+			a_out.seek_absolute(outpos);
+			if (remaining > 0) {
+				throw binary_io::buffer_exhausted();
+			}
+			return;
+		}
+#endif
+
+		detail::copy_buffered(a_in, a_out, a_count);
+	}
+
+	void copy(file_istream& a_in, pipe_ostream& a_out, std::size_t a_count)
+	{
+		assert(a_in.is_open() && a_out.is_open());
+		if (a_count == 0) {
+			return;
+		}
+
+#if BINARY_IO_OS_LINUX
+		// bytes which are still buffered for the pipe go first
+		a_out.flush();
+
+		auto inpos = static_cast<::off_t>(a_in.tell());
+		auto remaining = a_count;
+		if (os::splice_fd(
+				::fileno(a_in.rdbuf()),
+				&inpos,
+				a_out.native_handle(),
+				nullptr,
+				remaining)) {
+			a_in.seek_absolute(inpos);
+			a_out._pos += static_cast<binary_io::streamoff>(a_count - remaining);
+			if (remaining > 0) {
+				throw binary_io::buffer_exhausted();
+			}
+			return;
+		}
+#endif
+
+		detail::copy_buffered(a_in, a_out, a_count);
+	}
+
+	void mapped_file_ostream::reserve(std::size_t a_capacity)
+	{
+		assert(this->is_open());
+		if (a_capacity <= this->_capacity) {
+			return;
+		}
+
+		auto capacity = std::max({ a_capacity, this->_capacity * 2, growth_granularity });
+		capacity = (capacity + growth_granularity - 1) / growth_granularity * growth_granularity;
+
+#if BINARY_IO_OS_WINDOWS
+		// views can't be resized in place, so tear down the old one and map the file anew
+		(void)this->unmap();
+
+		::ULARGE_INTEGER size{};
+		size.QuadPart = capacity;
+		this->_mapping = ::CreateFileMappingW(this->_file, nullptr, PAGE_READWRITE, size.HighPart, size.LowPart, nullptr);
+		if (this->_mapping == nullptr) {
+			os::throw_last_error("failed to grow file mapping");
+		}
+
+		const auto data = ::MapViewOfFile(this->_mapping, FILE_MAP_WRITE, 0, 0, capacity);
+		if (data == nullptr) {
+			const auto error = ::GetLastError();
+			::CloseHandle(this->_mapping);
+			this->_mapping = nullptr;
+			::SetLastError(error);
+			os::throw_last_error("failed to map file");
+		}
+#else
+		if (::ftruncate(this->_file, static_cast<::off_t>(capacity)) != 0) {
+			os::throw_last_error("failed to grow file");
+		}
+
+#	if BINARY_IO_OS_LINUX
+		const auto data = this->_data != nullptr ?
+		                      ::mremap(this->_data, this->_capacity, capacity, MREMAP_MAYMOVE) :
+		                      ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, this->_file, 0);
+#	else
+		(void)this->unmap();
+		const auto data = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, this->_file, 0);
+#	endif
+		if (data == MAP_FAILED) {
+			os::throw_last_error("failed to map file");
+		}
+#endif
+
+		this->_data = static_cast<std::byte*>(data);
+		this->_capacity = capacity;
+	}
+
+	void mapped_file_ostream::open(
+		const directory_handle* a_directory,
+		const std::filesystem::path& a_path,
+		write_mode a_mode)
+	{
+		assert(a_directory == nullptr || a_directory->is_open());
+		this->close();
+
+		std::size_t size = 0;
+#if BINARY_IO_OS_WINDOWS
+		const auto path = a_directory != nullptr ?
+		                      a_directory->native_handle() / a_path :
+		                      a_path;
+		const auto file = ::CreateFileW(
+			path.c_str(),
+			GENERIC_READ | GENERIC_WRITE,
+			FILE_SHARE_READ,
+			nullptr,
+			a_mode == write_mode::truncate ? CREATE_ALWAYS : OPEN_ALWAYS,
+			FILE_ATTRIBUTE_NORMAL,
+			nullptr);
+		if (file == INVALID_HANDLE_VALUE) {
+			os::throw_last_error("failed to open file");
+		} else if (::GetFileType(file) != FILE_TYPE_DISK) {
+			::CloseHandle(file);
+			throw std::system_error{
+				ENOENT,
+				std::generic_category(),
+				"file is not a regular file"
+			};
+		}
+
+		::LARGE_INTEGER filesz{};
+		if (::GetFileSizeEx(file, &filesz) == 0) {
+			const auto error = ::GetLastError();
+			::CloseHandle(file);
+			::SetLastError(error);
+			os::throw_last_error("failed to get file size");
+		}
+
+		this->_file = file;
+		size = static_cast<std::size_t>(filesz.QuadPart);
+#else
+		struct ::stat st = {};
+		this->_file = os::open_regular(
+			a_directory,
+			a_path,
+			O_RDWR | O_CREAT | (a_mode == write_mode::truncate ? O_TRUNC : 0),
+			&st);
+		size = static_cast<std::size_t>(st.st_size);
+#endif
+
+		this->_size = size;
+		this->seek_absolute(a_mode == write_mode::append ? static_cast<binary_io::streamoff>(size) : 0);
+		if (size > 0) {
+			this->reserve(size);
+		}
+	}
+
+	std::error_code mapped_file_ostream::release() noexcept
+	{
+		if (!this->is_open()) {
+			return {};
+		}
+
+		// keep going after a failure, so that the handle is never leaked
+		auto error = this->unmap();
+#if BINARY_IO_OS_WINDOWS
+		::LARGE_INTEGER size{};
+		size.QuadPart = static_cast<::LONGLONG>(this->_size);
+		if ((::SetFilePointerEx(this->_file, size, nullptr, FILE_BEGIN) == 0 ||
+				::SetEndOfFile(this->_file) == 0) &&
+			!error) {
+			error.assign(static_cast<int>(::GetLastError()), std::system_category());
+		}
+		::CloseHandle(this->_file);
+		this->_file = nullptr;
+#else
+		if (::ftruncate(this->_file, static_cast<::off_t>(this->_size)) != 0 && !error) {
+			error.assign(errno, std::generic_category());
+		}
+		::close(this->_file);
+		this->_file = -1;
+#endif
+
+		this->_size = 0;
+		this->seek_absolute(0);
+		return error;
+	}
+
+	std::error_code mapped_file_ostream::unmap() noexcept
+	{
+		std::error_code error;
+#if BINARY_IO_OS_WINDOWS
+		if (this->_data != nullptr && ::UnmapViewOfFile(this->_data) == 0) {
+			error.assign(static_cast<int>(::GetLastError()), std::system_category());
+		}
+		if (this->_mapping != nullptr) {
+			::CloseHandle(this->_mapping);
+			this->_mapping = nullptr;
+		}
+#else
+		if (this->_data != nullptr && ::munmap(this->_data, this->_capacity) != 0) {
+			error.assign(errno, std::generic_category());
+		}
+#endif
+
+		this->_data = nullptr;
+		this->_capacity = 0;
+		return error;
+	}
+
+	void pack_reader::open(const std::filesystem::path& a_path)
+	{
+		this->close();
+
+		std::size_t size = 0;
+		void* data = nullptr;
+#if BINARY_IO_OS_WINDOWS
+		const auto file = ::CreateFileW(
+			a_path.c_str(),
+			GENERIC_READ,
+			FILE_SHARE_READ,
+			nullptr,
+			OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL,
+			nullptr);
+		if (file == INVALID_HANDLE_VALUE) {
+			os::throw_last_error("failed to open file");
+		}
+
+		::LARGE_INTEGER filesz{};
+		if (::GetFileSizeEx(file, &filesz) == 0) {
+			const auto error = ::GetLastError();
+			::CloseHandle(file);
+			::SetLastError(error);
+			os::throw_last_error("failed to get file size");
+		}
+
+		size = static_cast<std::size_t>(filesz.QuadPart);
+		if (size < format::header_size) {
+			::CloseHandle(file);
+			throw binary_io::exception("file is not a valid pack");
+		}
+
+		const auto mapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		const auto error = ::GetLastError();
+		::CloseHandle(file);
+		if (mapping == nullptr) {
+			::SetLastError(error);
+			os::throw_last_error("failed to map file");
+		}
+
+		data = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, size);
+		if (data == nullptr) {
+			const auto viewError = ::GetLastError();
+			::CloseHandle(mapping);
+			::SetLastError(viewError);
+			os::throw_last_error("failed to map file");
+		}
+		this->_mapping = mapping;
+#else
+		struct ::stat st = {};
+		const auto fd = os::open_regular(nullptr, a_path, O_RDONLY, &st);
+		size = static_cast<std::size_t>(st.st_size);
+		if (size < format::header_size) {
+			::close(fd);
+			throw binary_io::exception("file is not a valid pack");
+		}
+
+		data = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+		const auto error = errno;
+		::close(fd);
+		if (data == MAP_FAILED) {
+			throw std::system_error{ error, std::generic_category(), "failed to map file" };
+		}
+#endif
+
+		this->_data = static_cast<const std::byte*>(data);
+		this->_size = size;
+
+		const auto fits = [&](std::uint64_t a_offset, std::uint64_t a_count) noexcept {
+			return a_offset <= size && a_count <= size - a_offset;
+		};
+
+		span_istream header{ this->rdbuf() };
+		const auto [magic, version, entryCount, tableSize, indexOffset] =
+			header.read<std::uint32_t, std::uint32_t, std::uint64_t, std::uint64_t, std::uint64_t>(
+				std::endian::little);
+		bool valid =
+			magic == format::magic &&
+			version == format::version &&
+			(tableSize == 0 ? entryCount == 0 : std::has_single_bit(tableSize) && entryCount < tableSize) &&
+			fits(indexOffset, 0) &&
+			tableSize <= (size - indexOffset) / format::slot_size;
+
+		if (valid) {
+			this->_entryCount = static_cast<std::size_t>(entryCount);
+			this->_tableSize = static_cast<std::size_t>(tableSize);
+			this->_indexOffset = static_cast<std::size_t>(indexOffset);
+
+			std::size_t used = 0;
+			for (std::size_t i = 0; valid && i < this->_tableSize; ++i) {
+				const auto slot = this->slot(i);
+				if (slot.nameOffset != 0) {
+					valid = fits(slot.nameOffset, slot.nameSize) && fits(slot.dataOffset, slot.dataSize);
+					++used;
+				}
+			}
+			valid = valid && used == this->_entryCount;
+		}
+
+		if (!valid) {
+			this->close();
+			throw binary_io::exception("file is not a valid pack");
+		}
+	}
+
+	void pack_reader::close() noexcept
+	{
+		if (!this->is_open()) {
+			return;
+		}
+
+#if BINARY_IO_OS_WINDOWS
+		::UnmapViewOfFile(this->_data);
+		::CloseHandle(this->_mapping);
+		this->_mapping = nullptr;
+#else
+		::munmap(const_cast<std::byte*>(this->_data), this->_size);
+#endif
+
+		this->_data = nullptr;
+		this->_size = 0;
+		this->_entryCount = 0;
+		this->_tableSize = 0;
+		this->_indexOffset = 0;
+	}
+
+	auto pack_reader::lookup(std::string_view a_name) const noexcept
+		-> std::optional<std::span<const std::byte>>
+	{
+		if (this->_tableSize == 0) {
+			return std::nullopt;
+		}
+
+		const auto hash = format::hash(a_name);
+		const auto mask = this->_tableSize - 1;
+		for (auto pos = static_cast<std::size_t>(hash) & mask;; pos = (pos + 1) & mask) {
+			const auto slot = this->slot(pos);
+			if (slot.nameOffset == 0) {
+				return std::nullopt;
+			}
+
+			const std::string_view name{
+				reinterpret_cast<const char*>(this->_data + slot.nameOffset),
+				static_cast<std::size_t>(slot.nameSize)
+			};
+			if (slot.hash == hash && name == a_name) {
+				return this->rdbuf().subspan(
+					static_cast<std::size_t>(slot.dataOffset),
+					static_cast<std::size_t>(slot.dataSize));
+			}
+		}
+	}
+
+	detail::pack_slot pack_reader::slot(std::size_t a_index) const noexcept
+	{
+		const auto bytes = this->rdbuf().subspan(this->_indexOffset + a_index * format::slot_size);
+		const auto field = [&](std::size_t a_field) noexcept {
+			return binary_io::read<std::uint64_t>(
+				bytes.subspan(a_field * sizeof(std::uint64_t)).first<sizeof(std::uint64_t)>(),
+				std::endian::little);
+		};
+		return detail::pack_slot{ field(0), field(1), field(2), field(3), field(4) };
+	}
+
+	void huge_page_buffer::reserve(size_type a_capacity)
+	{
+		if (a_capacity <= this->_capacity) {
+			return;
+		}
+
+		if (a_capacity < mapping_threshold) {
+			const auto data = new std::byte[a_capacity];
+			if (this->_size != 0) {
+				std::memcpy(data, this->_data, this->_size);
+			}
+			this->deallocate();
+			this->_data = data;
+			this->_capacity = a_capacity;
+			this->_dirty = a_capacity;
+			this->_mapped = false;
+			return;
+		}
+
+		const auto capacity = (a_capacity + huge_page_size - 1) & ~(huge_page_size - 1);
+		if (this->_mapped) {
+			if (const auto data = os::remap_pages(this->_data, this->_capacity, capacity);
+				data != nullptr) {
+				this->_data = data;
+				this->_capacity = capacity;
+				this->place({ data, capacity });
+				return;
+			}
+		}
+
+		const auto data = os::map_pages(capacity, huge_page_size);
+		if (data == nullptr) {
+			throw std::bad_alloc();
+		}
+		this->place({ data, capacity });
+		if (this->_size != 0) {
+			std::memcpy(data, this->_data, this->_size);
+		}
+		this->deallocate();
+		this->_data = data;
+		this->_capacity = capacity;
+		this->_dirty = this->_size;
+		this->_mapped = true;
+	}
+
+	void huge_page_buffer::shrink_to_fit()
+	{
+		if (this->_size < mapping_threshold) {
+			if (!this->_mapped && this->_capacity == this->_size) {
+				return;
+			}
+
+			const auto data = this->_size != 0 ? new std::byte[this->_size] : nullptr;
+			if (this->_size != 0) {
+				std::memcpy(data, this->_data, this->_size);
+			}
+			this->deallocate();
+			this->_data = data;
+			this->_capacity = this->_size;
+			this->_dirty = this->_size;
+			this->_mapped = false;
+			return;
+		}
+
+		const auto capacity = (this->_size + huge_page_size - 1) & ~(huge_page_size - 1);
+		if (capacity < this->_capacity) {
+			if (const auto data = os::remap_pages(this->_data, this->_capacity, capacity);
+				data != nullptr) {
+				this->_data = data;
+				this->_capacity = capacity;
+				this->_dirty = std::min(this->_dirty, capacity);
+			}
+		}
+	}
+
+	void huge_page_buffer::place(std::span<const std::byte> a_pages) const noexcept
+	{
+		if (this->_numa.placement != numa_placement::first_touch) {
+			(void)binary_io::numa_bind(a_pages, this->_numa);
+		}
+	}
+
+	void huge_page_buffer::deallocate() noexcept
+	{
+		if (this->_mapped) {
+			os::unmap_pages(this->_data, this->_capacity);
+		} else {
+			delete[] this->_data;
+		}
+	}
+
+#if BINARY_IO_OS_LINUX
+	namespace
+	{
+		struct numa_nodes
+		{
+			std::size_t highest{ 0 };
+			std::uint64_t mask{ 1 };
+		};
+
+		// the online nodes, which need not be numbered densely, e.g. "0-3,5" after node 4 is
+		// taken offline
+		[[nodiscard]] const numa_nodes& online_numa_nodes() noexcept
+		{
+			static const auto nodes = []() noexcept {
+				numa_nodes result;
+				const auto file = std::fopen("/sys/devices/system/node/online", "r");
+				if (file == nullptr) {
+					return result;
+				}
+
+				result.mask = 0;
+				unsigned first = 0;
+				unsigned last = 0;
+				for (int matched = 0; (matched = std::fscanf(file, "%u-%u", &first, &last)) > 0;) {
+					if (matched == 1) {
+						last = first;
+					}
+					result.highest = std::max<std::size_t>(result.highest, last);
+					for (auto node = first; node <= last && node < 64; ++node) {
+						result.mask |= std::uint64_t{ 1 } << node;
+					}
+					if (std::fgetc(file) != ',') {
+						break;
+					}
+				}
+				std::fclose(file);
+
+				if (result.mask == 0) {
+					result = {};
+				}
+				return result;
+			}();
+			return nodes;
+		}
+	}
+#endif
+
+	std::size_t numa_node_count() noexcept
+	{
+#if BINARY_IO_OS_WINDOWS
+		::ULONG highest = 0;
+		return ::GetNumaHighestNodeNumber(&highest) != 0 ? highest + 1 : 1;
+#elif BINARY_IO_OS_LINUX
+		return online_numa_nodes().highest + 1;
+#else
+		return 1;
+#endif
+	}
+
+	std::size_t current_numa_node() noexcept
+	{
+#if BINARY_IO_OS_WINDOWS
+		::PROCESSOR_NUMBER processor{};
+		::GetCurrentProcessorNumberEx(&processor);
+		::USHORT node = 0;
+		return ::GetNumaProcessorNodeEx(&processor, &node) != 0 ? node : 0;
+#elif BINARY_IO_OS_LINUX
+		unsigned cpu = 0;
+		unsigned node = 0;
+		return ::syscall(SYS_getcpu, &cpu, &node, nullptr) == 0 ? node : 0;
+#else
+		return 0;
+#endif
+	}
+
+	bool numa_bind(
+		std::span<const std::byte> a_region,
+		const numa_policy& a_policy) noexcept
+	{
+#if BINARY_IO_OS_LINUX
+		if (a_region.empty()) {
+			return true;
+		}
+
+		int mode = MPOL_DEFAULT;
+		switch (a_policy.placement) {
+		case numa_placement::first_touch:
+			break;
+		case numa_placement::interleave:
+			mode = MPOL_INTERLEAVE;
+			break;
+		case numa_placement::bind:
+			mode = MPOL_BIND;
+			break;
+		default:
+			detail::declare_unreachable();
+		}
+
+		const unsigned long mask = a_policy.nodes != 0 ? a_policy.nodes : online_numa_nodes().mask;
+
+		const auto pagesz = os::page_size();
+		const auto first = reinterpret_cast<std::uintptr_t>(a_region.data()) & ~(pagesz - 1);
+		const auto last =
+			(reinterpret_cast<std::uintptr_t>(a_region.data() + a_region.size()) + pagesz - 1) &
+			~(pagesz - 1);
+		return ::syscall(
+				   SYS_mbind,
+				   first,
+				   last - first,
+				   mode,
+				   mode != MPOL_DEFAULT ? &mask : nullptr,
+				   mode != MPOL_DEFAULT ? sizeof(mask) * CHAR_BIT + 1 : 0,
+				   MPOL_MF_MOVE) == 0;
+#else
+		(void)a_region;
+		return a_policy.placement == numa_placement::first_touch;
+#endif
+	}
+
+	void prefault(std::span<std::byte> a_region) noexcept
+	{
+		const auto pagesz = os::page_size();
+		const auto base = reinterpret_cast<std::uintptr_t>(a_region.data());
+		for (auto offset = (pagesz - base % pagesz) % pagesz; offset < a_region.size(); offset += pagesz) {
+			const auto byte = static_cast<volatile std::byte*>(a_region.data() + offset);
+			*byte = *byte;
+		}
+		if (!a_region.empty()) {
+			const auto byte = static_cast<volatile std::byte*>(a_region.data());
+			*byte = *byte;
+		}
+	}
+
+	void prefault(std::span<const std::byte> a_region) noexcept
+	{
+		const auto pagesz = os::page_size();
+		const auto base = reinterpret_cast<std::uintptr_t>(a_region.data());
+		for (auto offset = (pagesz - base % pagesz) % pagesz; offset < a_region.size(); offset += pagesz) {
+			(void)*static_cast<const volatile std::byte*>(a_region.data() + offset);
+		}
+		if (!a_region.empty()) {
+			(void)*static_cast<const volatile std::byte*>(a_region.data());
 		}
 	}
 }
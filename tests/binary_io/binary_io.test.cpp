@@ -1,26 +1,47 @@
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
 #include <cstring>
 #include <filesystem>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <map>
 #include <memory>
+#include <numeric>
+#include <optional>
+#include <random>
 #include <span>
+#include <stdexcept>
+#include <string>
 #include <string_view>
 #include <system_error>
+#include <thread>
+#include <tuple>
 #include <type_traits>
 #include <typeinfo>
+#include <unordered_map>
 #include <utility>
+#include <variant>
 #include <vector>
 
 #include <catch2/catch_all.hpp>
 
 #ifdef _WIN32
 #	include <Windows.h>  // ensure windows.h compatibility
+#else
+#	include <sys/mman.h>
+#	include <sys/socket.h>
+#	include <unistd.h>
 #endif
 
 #include "binary_io/binary_io.hpp"
+#include "binary_io/differential.hpp"
+
+#include "local_file_header.hpp"
 
 using namespace std::literals;
 
@@ -361,6 +382,783 @@ TEST_CASE("file_stream is a move-only type")
 	test(std::in_place_type<binary_io::file_istream>);
 }
 
+TEST_CASE("file streams can be opened relative to a directory")
+{
+	const std::filesystem::path root{ "directory_handle_test"sv };
+	std::filesystem::remove_all(root);
+	std::filesystem::create_directories(root / "nested"sv);
+
+	const binary_io::directory_handle dir{ root };
+	REQUIRE(dir.is_open());
+	{
+		binary_io::file_ostream out{ dir, "a.bin"sv };
+		out.write(std::uint16_t{ 0x0102 });
+		out.open(dir, "a.bin"sv, binary_io::write_mode::append);
+		out.write(std::uint8_t{ 0x03 });
+	}
+	REQUIRE(std::filesystem::file_size(root / "a.bin"sv) == 3);
+
+	binary_io::file_istream in{ dir, "a.bin"sv };
+	REQUIRE(in.read<std::uint16_t, std::uint8_t>() == std::make_tuple(0x0102, 0x03));
+	in.open(root / "a.bin"sv);
+	REQUIRE(in.read<std::uint8_t>() == std::make_tuple(0x02));
+
+	REQUIRE_THROWS_AS(binary_io::file_istream(dir, "nested"sv), std::system_error);
+	REQUIRE_THROWS_AS(binary_io::file_istream(dir, "missing.bin"sv), std::system_error);
+	REQUIRE_THROWS_AS(binary_io::file_ostream(dir, "nested"sv), std::system_error);
+	REQUIRE_THROWS_AS(binary_io::directory_handle(root / "a.bin"sv), std::system_error);
+
+	binary_io::directory_handle nested{ root / "nested"sv };
+	auto moved = std::move(nested);
+	REQUIRE(!nested.is_open());
+	REQUIRE(moved.is_open());
+	(void)binary_io::file_ostream(moved, "b.bin"sv);
+	REQUIRE(std::filesystem::exists(root / "nested"sv / "b.bin"sv));
+}
+
+TEST_CASE("whole files can be read and written in one go")
+{
+	const std::filesystem::path root{ "whole_file_test"sv };
+	std::filesystem::remove_all(root);
+	std::filesystem::create_directories(root / "nested"sv);
+
+	const std::array payload{ std::byte{ 0x01 }, std::byte{ 0x02 }, std::byte{ 0x03 } };
+	binary_io::write_file(root / "a.bin"sv, payload);
+	REQUIRE(std::filesystem::file_size(root / "a.bin"sv) == payload.size());
+
+	auto in = binary_io::read_file(root / "a.bin"sv);
+	REQUIRE(in.rdbuf().size() == payload.size());
+	REQUIRE(in.read<std::uint8_t, std::uint16_t>() == std::make_tuple(0x01, 0x0302));
+
+	binary_io::write_file(root / "a.bin"sv, std::span<const std::byte>{});
+	REQUIRE(binary_io::read_file(root / "a.bin"sv).rdbuf().empty());
+
+	const binary_io::directory_handle dir{ root };
+	binary_io::write_file(dir, "b.bin"sv, std::span{ payload }.first(2));
+	REQUIRE(binary_io::read_file(dir, "b.bin"sv).read<std::uint16_t>() == std::make_tuple(0x0201));
+
+	REQUIRE_THROWS_AS(binary_io::read_file(root / "nested"sv), std::system_error);
+	REQUIRE_THROWS_AS(binary_io::read_file(dir, "missing.bin"sv), std::system_error);
+	REQUIRE_THROWS_AS(binary_io::write_file(dir, "nested"sv, payload), std::system_error);
+}
+
+TEST_CASE("many files can be read in one batch")
+{
+	const std::filesystem::path root{ "read_files_test"sv };
+	std::filesystem::remove_all(root);
+	std::filesystem::create_directories(root / "nested"sv);
+
+	std::vector<std::filesystem::path> paths;
+	for (std::size_t i = 0; i < 200; ++i) {
+		const std::vector bytes(i, static_cast<std::byte>(i));
+		paths.push_back("file"s + std::to_string(i));
+		binary_io::write_file(root / paths.back(), bytes);
+	}
+	paths.push_back("nested"sv);
+	paths.push_back("missing"sv);
+
+	const binary_io::directory_handle dir{ root };
+	std::vector<int> seen(paths.size());
+	binary_io::read_files(
+		dir,
+		paths,
+		[&](std::size_t a_index, std::error_code a_error, binary_io::memory_istream a_contents) {
+			++seen[a_index];
+			if (a_index < 200) {
+				REQUIRE(!a_error);
+				const auto bytes = a_contents.rdbuf();
+				REQUIRE(bytes.size() == a_index);
+				REQUIRE(std::all_of(bytes.begin(), bytes.end(), [&](std::byte a_byte) {
+					return a_byte == static_cast<std::byte>(a_index);
+				}));
+			} else {
+				REQUIRE(a_error);
+				REQUIRE(a_contents.rdbuf().empty());
+			}
+		});
+	REQUIRE(std::all_of(seen.begin(), seen.end(), [](int a_count) { return a_count == 1; }));
+
+	for (auto& path : paths) {
+		path = root / path;
+	}
+	std::size_t calls = 0;
+	REQUIRE_THROWS_AS(
+		binary_io::read_files(
+			std::span{ paths }.first(100),
+			[&](std::size_t, std::error_code, binary_io::memory_istream) {
+				++calls;
+				throw std::runtime_error("stop");
+			}),
+		std::runtime_error);
+	REQUIRE(calls == 1);
+}
+
+TEST_CASE("packs map many blobs from a single file")
+{
+	const std::filesystem::path filename{ "pack_test.bpak"sv };
+	std::filesystem::remove(filename);
+
+	const std::array payload{ std::byte{ 0x01 }, std::byte{ 0x02 }, std::byte{ 0x03 } };
+	binary_io::memory_ostream out;
+	out.write(std::uint8_t{ 0xFF });
+	{
+		binary_io::pack_writer writer{ out };
+		for (std::size_t i = 0; i < 100; ++i) {
+			writer.add("blob"s + std::to_string(i), std::span{ payload }.first(i % 4));
+		}
+		writer.add("empty"sv, {});
+		writer.finish();
+	}
+	const auto start = out.rdbuf().begin() + 1;
+	binary_io::write_file(filename, std::span{ start, out.rdbuf().end() });
+
+	binary_io::pack_reader pack{ filename };
+	REQUIRE(pack.is_open());
+	REQUIRE(pack.size() == 101);
+	for (std::size_t i = 0; i < 100; ++i) {
+		const auto name = "blob"s + std::to_string(i);
+		REQUIRE(pack.contains(name));
+		const auto blob = pack.at(name).rdbuf();
+		REQUIRE(blob.size() == i % 4);
+		REQUIRE(std::equal(blob.begin(), blob.end(), payload.begin()));
+		REQUIRE(reinterpret_cast<std::uintptr_t>(blob.data()) % 16 == 0);
+	}
+	REQUIRE(pack.find("empty"sv)->rdbuf().empty());
+	REQUIRE(!pack.find("blob100"sv));
+	REQUIRE_THROWS_AS((void)pack.at("missing"sv), binary_io::exception);
+
+	auto moved = std::move(pack);
+	REQUIRE(!pack.is_open());
+	REQUIRE(moved.at("blob3"sv).read<std::uint8_t, std::uint16_t>() == std::make_tuple(0x01, 0x0302));
+	moved.close();
+	REQUIRE(!moved.is_open());
+
+	{
+		binary_io::memory_ostream duplicates;
+		binary_io::pack_writer writer{ duplicates };
+		writer.add("a"sv, payload);
+		writer.add("a"sv, payload);
+		REQUIRE_THROWS_AS(writer.finish(), binary_io::exception);
+	}
+
+	binary_io::write_file(filename, std::span{ payload });
+	REQUIRE_THROWS_AS(binary_io::pack_reader(filename), binary_io::exception);
+	std::filesystem::resize_file(filename, 64);
+	REQUIRE_THROWS_AS(binary_io::pack_reader(filename), binary_io::exception);
+	REQUIRE_THROWS_AS(binary_io::pack_reader("missing.bpak"sv), std::system_error);
+
+	binary_io::memory_ostream empty;
+	binary_io::pack_writer{ empty }.finish();
+	binary_io::write_file(filename, empty.rdbuf());
+	binary_io::pack_reader emptyPack{ filename };
+	REQUIRE(emptyPack.size() == 0);
+	REQUIRE(!emptyPack.contains(""sv));
+}
+
+TEST_CASE("byte buffers grow without zeroing")
+{
+	binary_io::byte_buffer buffer(4);
+	REQUIRE(buffer.size() == 4);
+	REQUIRE(std::all_of(buffer.begin(), buffer.end(), [](std::byte a_byte) { return a_byte == std::byte{ 0 }; }));
+
+	std::fill(buffer.begin(), buffer.end(), std::byte{ 0xAA });
+	buffer.resize(2);
+	buffer.resize(6);
+	REQUIRE(buffer[1] == std::byte{ 0xAA });
+	REQUIRE(buffer[2] == std::byte{ 0 });
+	REQUIRE(buffer[5] == std::byte{ 0 });
+
+	buffer.resize(100, binary_io::default_init);
+	REQUIRE(buffer.size() == 100);
+	REQUIRE(buffer.capacity() >= 100);
+
+	const std::vector<std::byte> bytes{ std::byte{ 1 }, std::byte{ 2 }, std::byte{ 3 } };
+	const binary_io::byte_buffer copy{ bytes };
+	REQUIRE(copy == bytes);
+	REQUIRE(bytes == copy);
+	REQUIRE(copy != buffer);
+	REQUIRE(binary_io::byte_buffer(bytes.begin(), bytes.end()) == copy);
+
+	// the default memory streams hold a byte_buffer, but still trade buffers with vectors
+	STATIC_REQUIRE(std::same_as<binary_io::memory_ostream::container_type, binary_io::byte_buffer>);
+	STATIC_REQUIRE(std::same_as<binary_io::memory_istream::container_type, binary_io::byte_buffer>);
+	binary_io::memory_istream seeded{ bytes };
+	REQUIRE(seeded.read<std::uint8_t>() == std::make_tuple(1));
+	const std::vector<std::byte> exported = seeded.rdbuf();
+	REQUIRE(exported == bytes);
+
+	// bytes skipped over by a seek are zeroed, even though the window written after them isn't
+	binary_io::basic_memory_ostream<binary_io::byte_buffer> out;
+	out.rdbuf().resize(64, binary_io::default_init);
+	std::fill(out.rdbuf().begin(), out.rdbuf().end(), std::byte{ 0xFF });
+	out.rdbuf().clear();
+	out.seek_absolute(8);
+	out.write_bytes(bytes);
+	REQUIRE(out.rdbuf().size() == 11);
+	REQUIRE(std::all_of(out.rdbuf().begin(), out.rdbuf().begin() + 8, [](std::byte a_byte) {
+		return a_byte == std::byte{ 0 };
+	}));
+	REQUIRE(std::equal(bytes.begin(), bytes.end(), out.rdbuf().begin() + 8));
+
+	out.rdbuf().clear();
+	out.rdbuf().resize(11, binary_io::default_init);
+	std::fill(out.rdbuf().begin(), out.rdbuf().end(), std::byte{ 0xFF });
+	out.rdbuf().clear();
+	out.seek_absolute(0);
+	(void)out.prepare(11);
+	out.commit(1);
+	REQUIRE(std::all_of(out.rdbuf().begin(), out.rdbuf().end(), [](std::byte a_byte) {
+		return a_byte == std::byte{ 0 };
+	}));
+
+	// integral writes encode straight into an unzeroed window
+	out.rdbuf().resize(4, binary_io::default_init);
+	std::fill(out.rdbuf().begin(), out.rdbuf().end(), std::byte{ 0xFF });
+	out.rdbuf().clear();
+	out.seek_absolute(2);
+	out.write(std::endian::big, std::uint16_t{ 0x0102 });
+	REQUIRE(out.rdbuf() == std::vector{ std::byte{ 0 }, std::byte{ 0 }, std::byte{ 1 }, std::byte{ 2 } });
+
+	binary_io::huge_page_buffer huge;
+	huge.resize(16, binary_io::default_init);
+	REQUIRE(huge.size() == 16);
+}
+
+TEST_CASE("memory streams trim their buffers as they are reset")
+{
+	const std::vector<std::byte> large(1u << 20, std::byte{ 1 });
+	const std::vector<std::byte> small(100, std::byte{ 2 });
+
+	binary_io::memory_ostream out;
+	REQUIRE(out.trim_policy().factor == 0);
+	out.write_bytes(large);
+	const auto peak = out.rdbuf().capacity();
+	out.reset();
+	REQUIRE(out.rdbuf().empty());
+	REQUIRE(out.tell() == 0);
+	for (std::size_t i = 0; i < 100; ++i) {
+		out.write_bytes(small);
+		out.reset();
+	}
+	REQUIRE(out.rdbuf().capacity() == peak);
+
+	binary_io::trim_policy policy;
+	policy.factor = 4;
+	policy.decay = 2;
+	policy.min_capacity = 1024;
+	out.trim_policy(policy);
+	out.write_bytes(large);
+	out.reset();
+	REQUIRE(out.rdbuf().capacity() == peak);
+
+	// the spike decays away over a few resets, until the capacity settles near the floor
+	std::size_t resets = 0;
+	for (; out.rdbuf().capacity() > 4 * policy.min_capacity && resets < 100; ++resets) {
+		out.write_bytes(small);
+		REQUIRE(std::ranges::equal(out.rdbuf(), small));
+		out.reset();
+	}
+	REQUIRE(resets > 1);
+	REQUIRE(out.rdbuf().capacity() >= policy.min_capacity);
+	REQUIRE(out.rdbuf().capacity() <= 4 * policy.min_capacity);
+
+	// a renewed spike is remembered at once
+	out.write_bytes(large);
+	out.reset();
+	REQUIRE(out.rdbuf().capacity() >= large.size());
+
+	binary_io::basic_memory_ostream<binary_io::huge_page_buffer> huge;
+	huge.trim_policy(policy);
+	huge.write_bytes(std::vector<std::byte>(binary_io::huge_page_buffer::mapping_threshold * 2));
+	REQUIRE(huge.rdbuf().is_mapped());
+	huge.reset();
+	for (std::size_t i = 0; i < 100; ++i) {
+		huge.write_bytes(small);
+		huge.reset();
+	}
+	REQUIRE(!huge.rdbuf().is_mapped());
+	REQUIRE(huge.rdbuf().capacity() < binary_io::huge_page_buffer::mapping_threshold);
+}
+
+TEST_CASE("huge page buffers back large memory streams")
+{
+	using buffer_t = binary_io::huge_page_buffer;
+	binary_io::basic_memory_ostream<buffer_t> out;
+	out.write(std::uint32_t{ 0x01020304 });
+	REQUIRE(!out.rdbuf().is_mapped());
+
+	out.seek_absolute(buffer_t::mapping_threshold * 3 + 1);
+	out.write(std::uint8_t{ 0xFF });
+	const auto& buffer = out.rdbuf();
+	REQUIRE(buffer.is_mapped());
+	REQUIRE(buffer.size() == buffer_t::mapping_threshold * 3 + 2);
+	REQUIRE(buffer.capacity() % buffer_t::huge_page_size == 0);
+	REQUIRE(std::all_of(buffer.begin() + 4, buffer.end() - 1, [](std::byte a_byte) {
+		return a_byte == std::byte{ 0 };
+	}));
+
+	out.rdbuf().resize(2);
+	out.rdbuf().resize(8);
+	REQUIRE(std::all_of(buffer.begin() + 2, buffer.end(), [](std::byte a_byte) {
+		return a_byte == std::byte{ 0 };
+	}));
+
+	binary_io::basic_memory_istream<buffer_t> in{ buffer };
+	REQUIRE(in.read<std::uint16_t>() == std::make_tuple(0x0304));
+
+	buffer_t small{ 16 };
+	small[0] = std::byte{ 0x42 };
+	auto moved = std::move(small);
+	REQUIRE(small.empty());
+	REQUIRE(moved.size() == 16);
+	moved.swap(small);
+	REQUIRE(small[0] == std::byte{ 0x42 });
+	small = out.rdbuf();
+	REQUIRE(small.size() == 8);
+	small.clear();
+	REQUIRE(small.empty());
+}
+
+TEST_CASE("buffers can be placed on numa nodes")
+{
+	REQUIRE(binary_io::numa_node_count() >= 1);
+	REQUIRE(binary_io::current_numa_node() < binary_io::numa_node_count());
+
+	using buffer_t = binary_io::huge_page_buffer;
+	buffer_t buffer;
+	REQUIRE(buffer.numa_policy().placement == binary_io::numa_placement::first_touch);
+	buffer.numa_policy({ binary_io::numa_placement::interleave });
+	buffer.resize(buffer_t::mapping_threshold);
+	buffer[0] = std::byte{ 0x42 };
+	buffer.resize(buffer_t::mapping_threshold * 2);
+	REQUIRE(buffer.is_mapped());
+	REQUIRE(buffer[0] == std::byte{ 0x42 });
+
+	buffer.numa_policy({ binary_io::numa_placement::bind, std::uint64_t{ 1 } << binary_io::current_numa_node() });
+	binary_io::prefault(std::span{ buffer });
+	binary_io::prefault(std::as_bytes(std::span{ buffer }));
+	REQUIRE(buffer[0] == std::byte{ 0x42 });
+	REQUIRE(std::all_of(buffer.begin() + 1, buffer.end(), [](std::byte a_byte) {
+		return a_byte == std::byte{ 0 };
+	}));
+
+	const auto copy = buffer;
+	REQUIRE(copy.numa_policy().placement == binary_io::numa_placement::bind);
+	REQUIRE(binary_io::numa_bind({}, {}));
+	(void)binary_io::numa_bind(std::span{ copy }, {});
+}
+
+TEST_CASE("copy policies choose how bytes are copied")
+{
+	std::vector<std::byte> src(1000);
+	for (std::size_t i = 0; i < src.size(); ++i) {
+		src[i] = static_cast<std::byte>(i * 7);
+	}
+
+	for (const auto hint : { binary_io::cache_hint::automatic, binary_io::cache_hint::temporal, binary_io::cache_hint::non_temporal }) {
+		const binary_io::copy_policy policy{ hint, 64 };
+		for (const std::size_t offset : { 0, 1, 15 }) {
+			for (const std::size_t count : std::array<std::size_t, 6>{ 0, 1, 63, 64, 200, 999 - offset }) {
+				std::vector<std::byte> dst(src.size());
+				const auto from = std::span{ src }.subspan(offset, count);
+				binary_io::copy_bytes(std::span{ dst }.subspan(offset), from, policy);
+				REQUIRE(std::equal(from.begin(), from.end(), dst.begin() + offset));
+				REQUIRE(std::all_of(dst.begin() + offset + count, dst.end(), [](std::byte a_byte) {
+					return a_byte == std::byte{ 0 };
+				}));
+			}
+		}
+	}
+
+	binary_io::memory_ostream out;
+	REQUIRE(out.copy_policy().cache_hint == binary_io::cache_hint::automatic);
+	out.copy_policy({ binary_io::cache_hint::non_temporal });
+	out.write_bytes(src);
+	REQUIRE(std::equal(src.begin(), src.end(), out.rdbuf().begin(), out.rdbuf().end()));
+
+	std::vector<std::byte> buffer(src.size());
+	binary_io::span_ostream span{ buffer };
+	span.copy_policy(out.copy_policy());
+	span.write_bytes(src);
+	REQUIRE(buffer == src);
+
+	auto moved = std::move(out);
+	REQUIRE(moved.copy_policy().cache_hint == binary_io::cache_hint::non_temporal);
+
+	std::vector<std::byte> large((5u << 20) + 3);
+	for (std::size_t i = 0; i < large.size(); ++i) {
+		large[i] = static_cast<std::byte>(i % 251);
+	}
+	for (const auto concurrency : { 0, 1, 3, 4 }) {
+		binary_io::copy_policy policy;
+		policy.concurrency = static_cast<std::size_t>(concurrency);
+		policy.parallel_threshold = 1u << 20;
+
+		binary_io::memory_istream in{ large };
+		in.copy_policy(policy);
+		in.seek_absolute(1);
+		std::vector<std::byte> dst(large.size() - 1);
+		in.read_bytes(dst);
+		REQUIRE(std::equal(dst.begin(), dst.end(), large.begin() + 1));
+	}
+
+	// a destination which starts partway into a cache line still gets its leading bytes
+	std::vector<std::byte> storage(large.size() + 64);
+	const auto misalign = (64 + 5 - reinterpret_cast<std::uintptr_t>(storage.data()) % 64) % 64;
+	const auto misaligned = std::span{ storage }.subspan(misalign, large.size());
+	REQUIRE(reinterpret_cast<std::uintptr_t>(misaligned.data()) % 64 == 5);
+	binary_io::copy_policy policy;
+	policy.concurrency = 4;
+	policy.parallel_threshold = 1u << 20;
+	binary_io::copy_bytes(misaligned, large, policy);
+	REQUIRE(std::equal(misaligned.begin(), misaligned.begin() + 64, large.begin()));
+	REQUIRE(std::equal(misaligned.begin(), misaligned.end(), large.begin(), large.end()));
+}
+
+TEST_CASE("executors run parallel work")
+{
+	std::atomic_size_t ran = 0;
+	{
+		binary_io::work_stealing_executor executor{ 3 };
+		REQUIRE(executor.concurrency() == 3);
+		for (std::size_t i = 0; i < 100; ++i) {
+			executor.submit([&]() {
+				// tasks submitted by a worker land on its own queue, and may be stolen
+				for (std::size_t j = 0; j < 10; ++j) {
+					executor.submit([&]() { ++ran; });
+				}
+				++ran;
+			});
+		}
+	}
+	REQUIRE(ran == 1100);
+
+	REQUIRE(binary_io::default_executor().concurrency() >= 1);
+
+	class counting_executor final :
+		public binary_io::executor
+	{
+	public:
+		void submit(std::function<void()> a_task) override
+		{
+			++this->submitted;
+			this->_inner.submit(std::move(a_task));
+		}
+
+		std::size_t concurrency() const noexcept override { return this->_inner.concurrency(); }
+
+		std::atomic_size_t submitted{ 0 };
+
+	private:
+		binary_io::work_stealing_executor _inner{ 2 };
+	};
+
+	counting_executor counting;
+	binary_io::set_default_executor(&counting);
+	REQUIRE(&binary_io::default_executor() == &counting);
+
+	std::vector<std::byte> src((4u << 20) + 5);
+	for (std::size_t i = 0; i < src.size(); ++i) {
+		src[i] = static_cast<std::byte>(i % 239);
+	}
+	std::vector<std::byte> dst(src.size());
+	binary_io::copy_policy policy;
+	policy.concurrency = 0;
+	policy.parallel_threshold = 1u << 20;
+	binary_io::copy_bytes(dst, src, policy);
+	REQUIRE(dst == src);
+	REQUIRE(counting.submitted == 2);
+
+	binary_io::work_stealing_executor explicit_executor{ 1 };
+	policy.executor = &explicit_executor;
+	std::fill(dst.begin(), dst.end(), std::byte{ 0 });
+	binary_io::copy_bytes(dst, src, policy);
+	REQUIRE(dst == src);
+	REQUIRE(counting.submitted == 2);
+
+	binary_io::set_default_executor(nullptr);
+	REQUIRE(&binary_io::default_executor() != &counting);
+}
+
+namespace serialization
+{
+	struct vec3
+	{
+		std::int32_t x{ 0 };
+		std::int32_t y{ 0 };
+		std::int32_t z{ 0 };
+
+		friend bool operator==(const vec3&, const vec3&) = default;
+	};
+
+	constexpr std::size_t serialized_size(std::type_identity<vec3>) noexcept { return 12; }
+
+	template <class Stream>
+	void serialize(Stream& a_out, const vec3& a_value)
+	{
+		a_out.write(a_value.x, a_value.y, a_value.z);
+	}
+
+	template <class Stream>
+	void deserialize(Stream& a_in, vec3& a_value)
+	{
+		a_in.read(a_value.x, a_value.y, a_value.z);
+	}
+
+	struct segment
+	{
+		vec3 from;
+		vec3 to;
+		std::uint8_t flags{ 0 };
+	};
+
+	constexpr std::size_t serialized_size(std::type_identity<segment>) noexcept
+	{
+		return 2 * binary_io::serialized_size_v<vec3> + 1;
+	}
+
+	template <class Stream>
+	void serialize(Stream& a_out, const segment& a_value)
+	{
+		binary_io::serialize(a_out, a_value.from, a_value.to, a_value.flags);
+	}
+
+	template <class Stream>
+	void deserialize(Stream& a_in, segment& a_value)
+	{
+		binary_io::deserialize(a_in, a_value.from, a_value.to, a_value.flags);
+	}
+
+	struct label
+	{
+		std::string text;
+
+		friend bool operator==(const label&, const label&) = default;
+	};
+
+	std::size_t serialized_size(const label& a_value) noexcept { return 2 + a_value.text.size(); }
+
+	template <class Stream>
+	void serialize(Stream& a_out, const label& a_value)
+	{
+		a_out.write(static_cast<std::uint16_t>(a_value.text.size()));
+		a_out.write_bytes(std::as_bytes(std::span{ a_value.text }));
+	}
+
+	template <class Stream>
+	void deserialize(Stream& a_in, label& a_value)
+	{
+		const auto [size] = a_in.template read<std::uint16_t>();
+		a_value.text.resize(size);
+		a_in.read_bytes(std::as_writable_bytes(std::span{ a_value.text }));
+	}
+
+	// counts the calls made into a stream, to check that fixed size values are batched
+	class counting_istream final :
+		public binary_io::istream_interface<counting_istream>
+	{
+	public:
+		explicit counting_istream(std::span<const std::byte> a_bytes) noexcept :
+			_bytes(a_bytes)
+		{}
+
+		void read_bytes(std::span<std::byte> a_dst)
+		{
+			++this->calls;
+			REQUIRE(a_dst.size() <= this->_bytes.size());
+			std::copy_n(this->_bytes.begin(), a_dst.size(), a_dst.begin());
+			this->_bytes = this->_bytes.subspan(a_dst.size());
+		}
+
+		std::size_t calls{ 0 };
+
+	private:
+		std::span<const std::byte> _bytes;
+	};
+
+	class counting_ostream final :
+		public binary_io::ostream_interface<counting_ostream>
+	{
+	public:
+		void write_bytes(std::span<const std::byte> a_src)
+		{
+			++this->calls;
+			if (!a_src.empty()) {
+				const auto size = this->bytes.size();
+				this->bytes.resize(size + a_src.size());
+				std::memcpy(this->bytes.data() + size, a_src.data(), a_src.size());
+			}
+		}
+
+		std::size_t calls{ 0 };
+		std::vector<std::byte> bytes;
+	};
+}
+
+TEST_CASE("user types can be serialized")
+{
+	using serialization::label;
+	using serialization::segment;
+	using serialization::vec3;
+
+	STATIC_REQUIRE(binary_io::serialized_size_v<std::uint32_t> == 4);
+	STATIC_REQUIRE(binary_io::serialized_size_v<segment> == 25);
+	STATIC_REQUIRE(binary_io::concepts::fixed_size_serializable<vec3>);
+	STATIC_REQUIRE(!binary_io::concepts::fixed_size_serializable<label>);
+	STATIC_REQUIRE(binary_io::concepts::serializable<label, binary_io::memory_ostream>);
+	STATIC_REQUIRE(!binary_io::concepts::serializable<std::string, binary_io::memory_ostream>);
+
+	const segment seg{ { 1, -2, 3 }, { 4, 5, -6 }, 0x7F };
+	const label name{ "hello"s };
+	REQUIRE(binary_io::serialized_size(name) == 7);
+	REQUIRE(binary_io::serialized_size(seg) == 25);
+
+	binary_io::memory_ostream out;
+	out.endian(std::endian::big);
+	binary_io::serialize(out, seg, name, std::uint8_t{ 0xEE });
+	out << seg.from << name;
+	REQUIRE(out.rdbuf().size() == 25 + 7 + 1 + 12 + 7);
+	REQUIRE(out.rdbuf()[3] == std::byte{ 1 });  // the stream's endian format carries through
+	REQUIRE(out.rdbuf()[24] == std::byte{ 0x7F });
+	REQUIRE(out.rdbuf()[26] == std::byte{ 5 });
+
+	binary_io::memory_istream in{ out.rdbuf() };
+	in.endian(std::endian::big);
+	segment seg2;
+	label name2;
+	std::uint8_t tail = 0;
+	vec3 from2;
+	label name3;
+	binary_io::deserialize(in, seg2, name2, tail);
+	in >> from2 >> name3;
+	REQUIRE(seg2.from == seg.from);
+	REQUIRE(seg2.to == seg.to);
+	REQUIRE(seg2.flags == seg.flags);
+	REQUIRE(name2.text == name.text);
+	REQUIRE(tail == 0xEE);
+	REQUIRE(from2 == seg.from);
+	REQUIRE(name3.text == name.text);
+	REQUIRE_THROWS_AS(in >> from2, binary_io::buffer_exhausted);
+
+	// a run of fixed size values costs one call into the stream, however deeply they nest
+	serialization::counting_ostream counted;
+	binary_io::serialize(counted, seg, seg.from, std::uint32_t{ 9 });
+	REQUIRE(counted.calls == 1);
+	REQUIRE(counted.bytes.size() == 25 + 12 + 4);
+
+	serialization::counting_istream counting{ counted.bytes };
+	segment seg3;
+	vec3 from3;
+	std::uint32_t nine = 0;
+	binary_io::deserialize(counting, seg3, from3, nine);
+	REQUIRE(counting.calls == 1);
+	REQUIRE(seg3.to == seg.to);
+	REQUIRE(from3 == seg.from);
+	REQUIRE(nine == 9);
+}
+
+TEST_CASE("standard library types can be serialized")
+{
+	using serialization::label;
+	using serialization::vec3;
+
+	using record = std::tuple<
+		std::array<std::uint16_t, 3>,
+		std::optional<vec3>,
+		std::variant<std::uint8_t, label>,
+		std::vector<std::uint32_t>,
+		std::map<std::uint32_t, std::optional<label>>,
+		std::unordered_map<std::uint8_t, std::pair<std::int16_t, vec3>>>;
+
+	STATIC_REQUIRE(binary_io::serialized_size_v<std::array<vec3, 4>> == 48);
+	STATIC_REQUIRE(binary_io::serialized_size_v<std::pair<std::uint8_t, vec3>> == 13);
+	STATIC_REQUIRE(!binary_io::concepts::fixed_size_serializable<std::optional<std::uint8_t>>);
+	STATIC_REQUIRE(binary_io::concepts::serializable<record, binary_io::memory_ostream>);
+	STATIC_REQUIRE(binary_io::concepts::deserializable<record, binary_io::memory_istream>);
+	STATIC_REQUIRE(!binary_io::concepts::serializable<std::vector<std::string>, binary_io::memory_ostream>);
+
+	const record original{
+		{ 1, 2, 3 },
+		vec3{ 4, -5, 6 },
+		label{ "variant"s },
+		{ 7, 8, 9, 10 },
+		{ { 11, label{ "eleven"s } }, { 12, std::nullopt } },
+		{ { 13, { -14, { 15, 16, 17 } } } },
+	};
+	REQUIRE(binary_io::serialized_size(original) ==
+			6 + (1 + 12) + (1 + 2 + 7) + (8 + 16) + (8 + (4 + 1 + 8) + (4 + 1)) + (8 + 1 + 2 + 12));
+
+	const auto roundtrip = [&](std::endian a_endian) {
+		binary_io::memory_ostream out;
+		out.endian(a_endian);
+		out << original;
+		REQUIRE(out.rdbuf().size() == binary_io::serialized_size(original));
+
+		binary_io::memory_istream in{ out.rdbuf() };
+		in.endian(a_endian);
+		record copy;
+		std::get<3>(copy) = { 99, 99, 99, 99, 99, 99 };  // stale contents are replaced
+		in >> copy;
+		REQUIRE(copy == original);
+		REQUIRE_THROWS_AS(in >> copy, binary_io::buffer_exhausted);
+		return out.rdbuf();
+	};
+	roundtrip(std::endian::little);
+	const auto big = roundtrip(std::endian::big);
+	REQUIRE(big[1] == std::byte{ 1 });  // the stream's endian format carries through
+	REQUIRE(big[6] == std::byte{ 1 });  // an engaged optional
+	REQUIRE(big[19] == std::byte{ 1 });  // the index of the variant's alternative
+
+	// arrays of scalars, and of fixed size values, cost one call into the stream
+	std::vector<std::uint32_t> scalars(1000);
+	std::iota(scalars.begin(), scalars.end(), 0);
+	const std::array<vec3, 3> points{ vec3{ 1, 2, 3 }, vec3{ 4, 5, 6 }, vec3{ 7, 8, 9 } };
+	for (const auto endian : { std::endian::little, std::endian::big }) {
+		serialization::counting_ostream counted;
+		counted.endian(endian);
+		binary_io::serialize(counted, scalars);
+		REQUIRE(counted.calls == 2);  // the count, then the elements
+		binary_io::serialize(counted, points);
+		REQUIRE(counted.calls == 3);
+		REQUIRE(counted.bytes.size() == 8 + 4000 + 36);
+
+		serialization::counting_istream counting{ counted.bytes };
+		counting.endian(endian);
+		std::vector<std::uint32_t> scalars2;
+		std::array<vec3, 3> points2;
+		binary_io::deserialize(counting, scalars2, points2);
+		REQUIRE(counting.calls == 3);
+		REQUIRE(scalars2 == scalars);
+		REQUIRE(points2 == points);
+	}
+
+	// corrupt input is rejected
+	const auto read = []<class T>(std::initializer_list<std::uint8_t> a_bytes, T& a_value) {
+		std::vector<std::byte> bytes;
+		for (const auto byte : a_bytes) {
+			bytes.push_back(static_cast<std::byte>(byte));
+		}
+		binary_io::span_istream in{ bytes };
+		binary_io::deserialize(in, a_value);
+	};
+	std::optional<std::uint8_t> opt;
+	std::variant<std::uint8_t, std::uint16_t> var;
+	std::vector<vec3> points3;
+	std::map<std::uint8_t, std::uint8_t> map;
+	REQUIRE_THROWS_AS(read({ 2, 0 }, opt), binary_io::exception);
+	REQUIRE_THROWS_AS(read({ 2, 0, 0 }, var), binary_io::exception);
+	REQUIRE_THROWS_AS(read({ 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF }, points3), binary_io::buffer_exhausted);
+	REQUIRE_THROWS_AS(read({ 3, 0, 0, 0, 0, 0, 0, 0, 1, 2 }, map), binary_io::buffer_exhausted);
+	REQUIRE(points3.empty());
+	REQUIRE(map.empty());
+
+	// a count which can't be checked against the input up front isn't allocated for up front
+	std::vector<std::optional<std::uint8_t>> opts;
+	std::unordered_map<std::uint8_t, std::optional<std::uint8_t>> optMap;
+	REQUIRE_THROWS_AS(read({ 0, 0, 0, 0, 0, 1, 0, 0, 1, 7 }, opts), binary_io::buffer_exhausted);
+	REQUIRE_THROWS_AS(read({ 0, 0, 0, 0, 0, 1, 0, 0, 1, 1, 7 }, optMap), binary_io::buffer_exhausted);
+}
+
 TEST_CASE("writing 0 bytes to a stream is a no-op")
 {
 	const std::filesystem::path filename{ "zero_byte_write_test.txt"sv };
@@ -395,3 +1193,806 @@ TEST_CASE("reading 0 bytes from a stream is a no-op")
 	f(binary_io::memory_istream());
 	f(binary_io::span_istream());
 }
+
+TEST_CASE("record ranges decode fields lazily")
+{
+	SECTION("fixed-size records")
+	{
+		const std::array<std::uint8_t, 14> payload{
+			0x01, 0x00, 0x00, 0x00, 0xAA, 0xBB,
+			0x02, 0x00, 0x00, 0x00, 0xCC, 0xDD,
+			0xFF, 0xFF
+		};
+		binary_io::span_istream in{ std::as_bytes(std::span{ payload }) };
+		in.endian(std::endian::little);
+
+		const binary_io::fixed_record_range records{ in, 6, 2 };
+		REQUIRE(in.tell() == 12);
+		REQUIRE(records.size() == 2);
+		REQUIRE(records[0].get<std::uint32_t>(0) == 1);
+		REQUIRE(records[1].get<std::uint32_t>(0) == 2);
+		REQUIRE(records[1].get<std::uint16_t>(4) == 0xDDCC);
+		REQUIRE(records[0].read<std::uint8_t, std::uint8_t>(4) == std::make_tuple(0xAA, 0xBB));
+		REQUIRE_THROWS_AS(records[0].get<std::uint32_t>(4), binary_io::buffer_exhausted);
+
+		std::uint32_t sum = 0;
+		for (const auto record : records) {
+			sum += record.get<std::uint32_t>(0);
+		}
+		REQUIRE(sum == 3);
+
+		REQUIRE_THROWS_AS((binary_io::fixed_record_range{ in, 6, 1 }), binary_io::buffer_exhausted);
+		in.seek_absolute(0);
+		REQUIRE_THROWS_AS(
+			(binary_io::fixed_record_range{ in, 6, std::numeric_limits<std::size_t>::max() / 3 }),
+			binary_io::buffer_exhausted);
+		REQUIRE(in.tell() == 0);
+	}
+
+	SECTION("length-prefixed records")
+	{
+		const std::array<std::uint8_t, 11> payload{
+			0x00, 0x02, 0x12, 0x34,
+			0x00, 0x00,
+			0x00, 0x03, 0x56, 0x78, 0x9A
+		};
+		binary_io::span_istream in{ std::as_bytes(std::span{ payload }) };
+		in.endian(std::endian::big);
+
+		const binary_io::prefixed_record_range<std::uint16_t> records{ in };
+		REQUIRE(in.tell() == static_cast<binary_io::streamoff>(payload.size()));
+
+		std::vector<std::size_t> sizes;
+		for (const auto& record : records) {
+			sizes.push_back(record.size());
+		}
+		REQUIRE(sizes == std::vector<std::size_t>{ 2, 0, 3 });
+
+		auto it = records.begin();
+		REQUIRE(it->get<std::uint16_t>(0) == 0x1234);
+		std::ranges::advance(it, 2);
+		REQUIRE(it->stream().read<std::uint8_t, std::uint16_t>() == std::make_tuple(0x56, 0x789A));
+		REQUIRE(++it == records.end());
+
+		const std::array<std::uint8_t, 3> truncated{ 0x00, 0x04, 0x00 };
+		const binary_io::prefixed_record_range<std::uint16_t> bad{ std::as_bytes(std::span{ truncated }), std::endian::big };
+		REQUIRE_THROWS_AS(bad.begin(), binary_io::buffer_exhausted);
+	}
+}
+
+TEST_CASE("chunk ranges yield tagged substreams")
+{
+	binary_io::memory_ostream out;
+	out.endian(std::endian::little);
+	out.write<std::uint32_t, std::uint32_t>(0x01, 3);
+	out.write<std::uint8_t, std::uint16_t>(0xAA, 0xBBCC);
+	out.write(std::uint8_t{ 0x00 });  // padding
+	out.write<std::uint32_t, std::uint32_t>(0x02, 0);
+	out.write<std::uint32_t, std::uint32_t>(0x03, 4);
+	out.write(std::uint32_t{ 0xDEADBEEF });
+	const auto payload = out.rdbuf();
+
+	const auto test = [](auto& a_in) {
+		std::vector<std::uint32_t> tags;
+		for (auto& chunk : binary_io::chunk_range{ a_in, std::endian::little, 2 }) {
+			tags.push_back(chunk.tag);
+			switch (chunk.tag) {
+			case 0x01:
+				REQUIRE(chunk.size == 3);
+				REQUIRE(chunk.stream.template read<std::uint8_t>() == std::make_tuple(0xAA));
+				// the remainder of the chunk is skipped
+				break;
+			case 0x02:
+				REQUIRE(chunk.size == 0);
+				REQUIRE_THROWS_AS(chunk.stream.template read<std::uint8_t>(), binary_io::buffer_exhausted);
+				break;
+			case 0x03:
+				REQUIRE(chunk.stream.template read<std::uint32_t>() == std::make_tuple(0xDEADBEEF));
+				break;
+			default:
+				FAIL();
+			}
+		}
+		REQUIRE(tags == std::vector<std::uint32_t>{ 1, 2, 3 });
+	};
+
+	SECTION("no-copy stream")
+	{
+		binary_io::span_istream in{ std::span{ payload } };
+		test(in);
+		static_assert(std::same_as<
+			binary_io::chunk_range<binary_io::span_istream>::substream_type,
+			binary_io::span_istream>);
+	}
+
+	SECTION("file stream")
+	{
+		const std::filesystem::path path{ "chunk_range_test.bin"sv };
+		{
+			binary_io::file_ostream f{ path };
+			f.write_bytes(std::span{ payload });
+		}
+
+		binary_io::file_istream in{ path };
+		test(in);
+	}
+
+	SECTION("truncated chunk")
+	{
+		binary_io::span_istream in{ std::span{ payload }.first(10) };
+		binary_io::chunk_range chunks{ in, std::endian::little };
+		REQUIRE_THROWS_AS(chunks.begin(), binary_io::buffer_exhausted);
+	}
+
+	SECTION("truncated header")
+	{
+		std::vector<std::byte> bytes{ payload.begin(), payload.begin() + 12 };
+		bytes.resize(bytes.size() + 5, std::byte{ 0xEE });
+
+		const auto truncated = [](auto& a_in) {
+			binary_io::chunk_range chunks{ a_in, std::endian::little, 2 };
+			auto it = chunks.begin();
+			REQUIRE(it != chunks.end());
+			REQUIRE(it->tag == 1);
+			REQUIRE_THROWS_AS(++it, binary_io::buffer_exhausted);
+		};
+
+		binary_io::span_istream in{ std::span{ bytes } };
+		truncated(in);
+
+		binary_io::memory_istream memory{ bytes };
+		truncated(memory);
+
+		const std::filesystem::path path{ "chunk_range_truncated_test.bin"sv };
+		{
+			binary_io::file_ostream f{ path };
+			f.write_bytes(std::span{ bytes });
+		}
+		binary_io::file_istream file{ path };
+		truncated(file);
+	}
+
+	SECTION("oversized chunk")
+	{
+		const auto oversized = [](std::uint64_t a_size) {
+			binary_io::memory_ostream bytes;
+			bytes.endian(std::endian::little);
+			bytes.write<std::uint32_t, std::uint64_t, std::uint32_t>(0x01, a_size, 0xDEADBEEF);
+			return bytes.rdbuf();
+		};
+		const auto begin = [](auto& a_in) {
+			binary_io::chunk_range<std::remove_cvref_t<decltype(a_in)>, std::uint32_t, std::uint64_t> chunks{
+				a_in,
+				std::endian::little,
+				2
+			};
+			(void)chunks.begin();
+		};
+
+		const std::filesystem::path path{ "chunk_range_oversized_test.bin"sv };
+		const auto check = [&]<class Exception>(std::uint64_t a_size, std::type_identity<Exception>) {
+			const auto bytes = oversized(a_size);
+			{
+				binary_io::file_ostream f{ path };
+				f.write_bytes(std::span{ bytes });
+			}
+
+			binary_io::span_istream in{ std::span{ bytes } };
+			REQUIRE_THROWS_AS(begin(in), Exception);
+			binary_io::file_istream file{ path };
+			REQUIRE_THROWS_AS(begin(file), Exception);
+		};
+
+		// sizes which would wrap the offset of the next chunk are rejected outright
+		check(~std::uint64_t{ 0 }, std::type_identity<binary_io::exception>{});
+		check(std::uint64_t{ 1 } << 63, std::type_identity<binary_io::exception>{});
+		check((std::uint64_t{ 1 } << 63) - 1, std::type_identity<binary_io::exception>{});
+
+		// sizes which run past the end of the stream are rejected before the chunk is handed out
+		check(100, std::type_identity<binary_io::buffer_exhausted>{});
+	}
+}
+
+TEST_CASE("generated layouts round-trip")
+{
+	layouts::local_file_header header;
+	header.local_file_header_signature = 0x04034B50;
+	header.compression_method = 8;
+	header.crc_32_of_uncompressed_data = 0xCAFEBABE;
+	header.file_name = "hello.txt"s;
+	header.extra_field = { std::byte{ 0x01 }, std::byte{ 0x02 } };
+
+	layouts::version_block version;
+	version.version = { 1, 2, 3 };
+	version.build = -42;
+
+	binary_io::memory_ostream out;
+	out.endian(std::endian::big);  // layouts which declare an endian format ignore the default
+	write(out, header);
+	write(out, version);
+
+	const auto& buf = out.rdbuf();
+	REQUIRE(buf.size() == 30 + 9 + 2 + 7);
+	REQUIRE(buf[0] == std::byte{ 0x50 });  // little-endian signature
+	REQUIRE(buf[26] == std::byte{ 9 });    // length fields are derived from the data
+	REQUIRE(buf[28] == std::byte{ 2 });
+	REQUIRE(buf[41] == std::byte{ 1 });
+	REQUIRE(buf[47] == std::byte{ 0xD6 });  // big-endian build
+
+	binary_io::span_istream in{ std::span{ buf } };
+	layouts::local_file_header header2;
+	layouts::version_block version2;
+	read(in, header2);
+	read(in, version2);
+	REQUIRE(in.tell() == static_cast<binary_io::streamoff>(buf.size()));
+
+	REQUIRE(header2.local_file_header_signature == header.local_file_header_signature);
+	REQUIRE(header2.compression_method == header.compression_method);
+	REQUIRE(header2.crc_32_of_uncompressed_data == header.crc_32_of_uncompressed_data);
+	REQUIRE(header2.file_name_length == 9);
+	REQUIRE(header2.file_name == header.file_name);
+	REQUIRE(header2.extra_field == header.extra_field);
+	REQUIRE(version2.version == version.version);
+	REQUIRE(version2.build == version.build);
+
+	// data which doesn't fit its length field is rejected, rather than written with a wrong length
+	header.file_name.assign(0x10000, 'x');
+	binary_io::memory_ostream out2;
+	REQUIRE_THROWS_AS(write(out2, header), binary_io::exception);
+	REQUIRE(out2.rdbuf().empty());
+
+	// lengths read from the input are only trusted as far as the input goes
+	const auto blob = [](std::uint64_t a_dataLength, std::int32_t a_noteLength) {
+		binary_io::memory_ostream bytes;
+		bytes.endian(std::endian::little);
+		bytes.write(a_dataLength, a_noteLength, std::uint32_t{ 0x01020304 });
+		return bytes.rdbuf();
+	};
+	const auto read_blob = [](const std::vector<std::byte>& a_bytes) {
+		binary_io::span_istream in{ std::span{ a_bytes } };
+		layouts::blob value;
+		read(in, value);
+		return value;
+	};
+	REQUIRE(read_blob(blob(4, 0)).data.size() == 4);
+	REQUIRE_THROWS_AS(read_blob(blob(std::uint64_t{ 1 } << 40, 0)), binary_io::buffer_exhausted);
+	REQUIRE_THROWS_AS(read_blob(blob(0, -1)), binary_io::exception);
+	REQUIRE_THROWS_AS(read_blob(blob(0, 5)), binary_io::buffer_exhausted);
+}
+
+TEST_CASE("versioned records tolerate added fields")
+{
+	binary_io::memory_ostream out;
+
+	// a newer writer which knows about 4 fields
+	{
+		binary_io::versioned_record_writer w{ out, 4 };
+		w.write(std::uint32_t{ 1 }, std::uint16_t{ 2 });
+		w.skip();
+		w.write(std::uint8_t{ 3 });
+		w.write(std::uint64_t{ 4 });
+		w.finish();
+	}
+	out.write(std::uint8_t{ 0xEE });  // trailing data
+
+	REQUIRE(out.rdbuf().size() == 1 + 4 + 1 + 6 + 1 + 8 + 1);
+	REQUIRE(out.rdbuf()[5] == std::byte{ 0b1101 });
+
+	SECTION("older reader")
+	{
+		binary_io::memory_istream in{ out.rdbuf() };
+		binary_io::versioned_record_reader r{ in };
+		REQUIRE(r.field_count() == 4);
+
+		std::uint32_t a = 0;
+		std::uint16_t b = 0;
+		std::uint32_t c = 99;
+		REQUIRE(r.read(a, b));
+		REQUIRE(!r.read(c));
+		REQUIRE(a == 1);
+		REQUIRE(b == 2);
+		REQUIRE(c == 99);
+		r.finish();
+
+		REQUIRE(in.read<std::uint8_t>() == std::make_tuple(0xEE));
+	}
+
+	SECTION("newer reader")
+	{
+		binary_io::memory_istream in{ out.rdbuf() };
+		binary_io::versioned_record_reader r{ in };
+
+		std::uint32_t a = 0;
+		std::uint16_t b = 0;
+		std::uint32_t c = 99;
+		std::uint8_t d = 0;
+		std::uint64_t e = 0;
+		std::uint16_t f = 7;
+		REQUIRE(r.read(a, b));
+		REQUIRE(!r.read(c));
+		REQUIRE(r.read(d));
+		REQUIRE(r.read(e));
+		REQUIRE(!r.read(f));
+		REQUIRE(d == 3);
+		REQUIRE(e == 4);
+		REQUIRE(f == 7);
+		REQUIRE(!r.has_field(64));
+		r.finish();
+
+		REQUIRE(in.read<std::uint8_t>() == std::make_tuple(0xEE));
+	}
+}
+
+TEST_CASE("mapped file streams grow and truncate on close")
+{
+	const std::filesystem::path path{ "mapped_file_test.bin"sv };
+	std::filesystem::remove(path);
+
+	{
+		binary_io::mapped_file_ostream out{ path };
+		REQUIRE(out.is_open());
+		REQUIRE(out.size() == 0);
+
+		out.seek_absolute(4);
+		out.write(std::endian::big, std::uint32_t{ 0xDEADBEEF });
+		out.seek_absolute(0);
+		out.write(std::endian::little, std::uint32_t{ 0x01020304 });
+		REQUIRE(out.size() == 8);
+		REQUIRE(out.capacity() >= binary_io::mapped_file_ostream::growth_granularity);
+
+		const auto window = out.prepare(3);
+		REQUIRE(window.size() == 3);
+		std::memset(window.data(), 0xAB, 2);
+		out.commit(2);
+		REQUIRE(out.tell() == 6);
+		REQUIRE(out.size() == 8);
+
+		out.seek_absolute(static_cast<binary_io::streamoff>(binary_io::mapped_file_ostream::growth_granularity));
+		out.write(std::uint8_t{ 0xFF });
+		REQUIRE(out.size() == binary_io::mapped_file_ostream::growth_granularity + 1);
+		out.seek_absolute(8);
+	}
+	REQUIRE(std::filesystem::file_size(path) == binary_io::mapped_file_ostream::growth_granularity + 1);
+
+	{
+		binary_io::mapped_file_ostream out{ path };
+		out.write(std::endian::little, std::uint32_t{ 0x01020304 });
+		out.write(std::uint16_t{ 0xABAB });
+		out.write(std::endian::big, std::uint16_t{ 0xBEEF });
+	}
+	REQUIRE(std::filesystem::file_size(path) == 8);
+
+	{
+		binary_io::mapped_file_ostream out{ path, binary_io::write_mode::append };
+		REQUIRE(out.tell() == 8);
+		REQUIRE(out.size() == 8);
+		out.write(std::uint8_t{ 0x42 });
+	}
+
+	binary_io::file_istream in{ path };
+	std::array<std::byte, 9> bytes{};
+	in.read_bytes(std::span{ bytes });
+	REQUIRE(bytes == std::array{
+						 std::byte{ 0x04 }, std::byte{ 0x03 }, std::byte{ 0x02 }, std::byte{ 0x01 },
+						 std::byte{ 0xAB }, std::byte{ 0xAB },
+						 std::byte{ 0xBE }, std::byte{ 0xEF },
+						 std::byte{ 0x42 } });
+
+	binary_io::mapped_file_ostream moved{ path, binary_io::write_mode::append };
+	auto other = std::move(moved);
+	REQUIRE(!moved.is_open());
+	REQUIRE(other.is_open());
+	REQUIRE_NOTHROW(other.close());
+	REQUIRE(!other.is_open());
+	REQUIRE(std::filesystem::file_size(path) == 9);
+
+	const std::filesystem::path root{ "mapped_file_directory_test"sv };
+	std::filesystem::remove_all(root);
+	std::filesystem::create_directories(root / "nested"sv);
+	const binary_io::directory_handle dir{ root };
+	{
+		binary_io::mapped_file_ostream relative{ dir, "a.bin"sv };
+		relative.write(std::endian::big, std::uint16_t{ 0xBEEF });
+	}
+	REQUIRE(std::filesystem::file_size(root / "a.bin"sv) == 2);
+	{
+		binary_io::mapped_file_ostream relative{ dir, "a.bin"sv, binary_io::write_mode::append };
+		REQUIRE(relative.tell() == 2);
+	}
+
+	REQUIRE_THROWS_AS(binary_io::mapped_file_ostream(dir, "nested"sv), std::system_error);
+	REQUIRE_THROWS_AS(binary_io::mapped_file_ostream(root), std::system_error);
+	REQUIRE(std::filesystem::is_directory(root / "nested"sv));
+}
+
+TEST_CASE("contiguous output streams encode in place")
+{
+	STATIC_REQUIRE(binary_io::concepts::contiguous_output_stream<binary_io::span_ostream>);
+	STATIC_REQUIRE(binary_io::concepts::contiguous_output_stream<binary_io::memory_ostream>);
+	STATIC_REQUIRE(binary_io::concepts::contiguous_output_stream<binary_io::mapped_file_ostream>);
+	STATIC_REQUIRE(!binary_io::concepts::contiguous_output_stream<binary_io::file_ostream>);
+	STATIC_REQUIRE(!binary_io::concepts::contiguous_output_stream<binary_io::any_ostream>);
+
+	const auto test = [](auto& a_out) {
+		const auto window = a_out.prepare(4);
+		REQUIRE(window.size() == 4);
+		REQUIRE(a_out.tell() == 0);
+		window[0] = std::byte{ 0xAA };
+		window[1] = std::byte{ 0xBB };
+		a_out.commit(2);
+		REQUIRE(a_out.tell() == 2);
+
+		a_out.write(std::endian::big, std::uint16_t{ 0x0102 }, std::uint8_t{ 0x03 });
+		REQUIRE(a_out.tell() == 5);
+	};
+	const std::array expected{
+		std::byte{ 0xAA },
+		std::byte{ 0xBB },
+		std::byte{ 0x01 },
+		std::byte{ 0x02 },
+		std::byte{ 0x03 },
+	};
+
+	SECTION("span_ostream")
+	{
+		std::array<std::byte, 5> buffer{};
+		binary_io::span_ostream out{ std::span{ buffer } };
+		test(out);
+		REQUIRE(buffer == expected);
+		REQUIRE_THROWS_AS(out.prepare(1), binary_io::buffer_exhausted);
+		REQUIRE(out.prepare(0).empty());
+	}
+
+	SECTION("memory_ostream")
+	{
+		binary_io::memory_ostream out;
+		test(out);
+		REQUIRE(std::ranges::equal(out.rdbuf(), expected));
+
+		// a window prepared for an upper bound only keeps the bytes which are committed
+		const auto window = out.prepare(100);
+		window[0] = std::byte{ 0x04 };
+		out.commit(1);
+		REQUIRE(out.tell() == 6);
+		REQUIRE(out.rdbuf().size() == 6);
+
+		// and a window which is never committed is discarded by the next write
+		(void)out.prepare(100);
+		out.write(std::uint8_t{ 0x05 });
+		REQUIRE(out.rdbuf().size() == 7);
+		REQUIRE(out.rdbuf()[6] == std::byte{ 0x05 });
+
+		// overwriting committed bytes never cuts the buffer short
+		out.seek_absolute(1);
+		(void)out.prepare(2);
+		out.commit(1);
+		REQUIRE(out.rdbuf().size() == 7);
+	}
+}
+
+TEST_CASE("stream references erase streams without owning them")
+{
+	STATIC_REQUIRE(std::is_trivially_copyable_v<binary_io::any_istream_ref>);
+	STATIC_REQUIRE(std::is_trivially_copyable_v<binary_io::any_ostream_ref>);
+	STATIC_REQUIRE(!std::is_default_constructible_v<binary_io::any_istream_ref>);
+
+	const auto produce = [](binary_io::any_ostream_ref a_out) {
+		a_out.write(std::uint16_t{ 0x0102 }, std::uint8_t{ 0x03 });
+		a_out.seek_relative(1);
+		a_out.write_bytes(std::as_bytes(std::span{ "xy", 2 }));
+	};
+	const auto consume = [](binary_io::any_istream_ref a_in) {
+		return a_in.read<std::uint16_t, std::uint8_t>();
+	};
+
+	binary_io::memory_ostream memory;
+	memory.endian(std::endian::big);
+	produce(memory);
+	REQUIRE(memory.tell() == 6);
+	REQUIRE(memory.rdbuf().size() == 6);
+
+	std::array<std::byte, 6> buffer{};
+	binary_io::any_ostream any{ binary_io::span_ostream{ std::span{ buffer } } };
+	any.endian(std::endian::big);
+	produce(any);
+	REQUIRE(any.tell() == 6);
+	REQUIRE(std::ranges::equal(buffer, memory.rdbuf()));
+
+	binary_io::span_istream in{ std::span{ std::as_const(buffer) } };
+	in.endian(std::endian::big);
+	REQUIRE(consume(in) == std::make_tuple(0x0102, 0x03));
+	REQUIRE(in.tell() == 3);
+
+	binary_io::any_istream_ref ref{ in };
+	ref.endian(std::endian::little);
+	ref.seek_absolute(0);
+	const auto copy = ref;
+	REQUIRE(copy.tell() == 0);
+	REQUIRE(ref.read<std::uint16_t>() == std::make_tuple(0x0201));
+	REQUIRE(in.endian() == std::endian::big);
+	REQUIRE(in.tell() == 2);
+}
+
+TEST_CASE("variant streams dispatch to the active stream")
+{
+	using istream_t = binary_io::variant_istream<binary_io::span_istream, binary_io::memory_istream>;
+	using ostream_t = binary_io::variant_ostream<binary_io::span_ostream, binary_io::memory_ostream>;
+	STATIC_REQUIRE(binary_io::concepts::no_copy_input_stream<istream_t>);
+	STATIC_REQUIRE(binary_io::concepts::contiguous_output_stream<ostream_t>);
+	STATIC_REQUIRE(!binary_io::concepts::no_copy_input_stream<
+				   binary_io::variant_istream<binary_io::span_istream, binary_io::file_istream>>);
+	STATIC_REQUIRE(!binary_io::concepts::contiguous_output_stream<
+				   binary_io::variant_ostream<binary_io::span_ostream, binary_io::file_ostream>>);
+
+	ostream_t out;
+	REQUIRE(out.index() == 0);
+	out.emplace<binary_io::memory_ostream>();
+	REQUIRE(out.get_if<binary_io::span_ostream>() == nullptr);
+	out.endian(std::endian::big);
+	out.write(std::uint16_t{ 0x0102 }, std::uint32_t{ 0x03040506 });
+	out.seek_relative(-1);
+	out.write(std::uint8_t{ 0xFF });
+	REQUIRE(out.tell() == 6);
+	REQUIRE_THROWS_AS(out.get<binary_io::span_ostream>(), std::bad_variant_access);
+
+	istream_t in{ binary_io::memory_istream{ std::move(out.get<binary_io::memory_ostream>().rdbuf()) } };
+	REQUIRE(in.index() == 1);
+	in.endian(std::endian::big);
+	REQUIRE(in.read<std::uint16_t, std::uint32_t>() == std::make_tuple(0x0102, 0x030405FF));
+	REQUIRE_THROWS_AS(in.read<std::uint8_t>(), binary_io::buffer_exhausted);
+
+	const std::array<std::byte, 2> bytes{ std::byte{ 0xAA }, std::byte{ 0xBB } };
+	in.emplace<binary_io::span_istream>(std::span{ bytes });
+	REQUIRE(in.tell() == 0);
+	REQUIRE(in.read_bytes(2).data() == bytes.data());
+	in.flush();
+}
+
+TEST_CASE("streams can be copied between each other")
+{
+	std::vector<std::byte> payload(3 * (1u << 20) + 17);
+	for (std::size_t i = 0; i < payload.size(); ++i) {
+		payload[i] = static_cast<std::byte>(i * 31 % 251);
+	}
+	const auto expect = [&](std::span<const std::byte> a_bytes, std::size_t a_offset, std::size_t a_count) {
+		REQUIRE(std::ranges::equal(a_bytes, std::span{ payload }.subspan(a_offset, a_count)));
+	};
+
+	SECTION("between memory streams")
+	{
+		binary_io::span_istream in{ std::span{ std::as_const(payload) } };
+		in.seek_absolute(5);
+		binary_io::memory_ostream out;
+		binary_io::copy(in, out, 100);
+		REQUIRE(in.tell() == 105);
+		REQUIRE(out.tell() == 100);
+		expect(out.rdbuf(), 5, 100);
+
+		std::array<std::byte, 8> buffer{};
+		binary_io::span_ostream small{ std::span{ buffer } };
+		REQUIRE_THROWS_AS(binary_io::copy(in, small, 9), binary_io::buffer_exhausted);
+	}
+
+	SECTION("through an intermediate buffer")
+	{
+		binary_io::any_istream in{ binary_io::memory_istream{ payload } };
+		binary_io::any_ostream out{ std::in_place_type<binary_io::memory_ostream> };
+		binary_io::copy(in, out, payload.size());
+		REQUIRE(in.tell() == static_cast<binary_io::streamoff>(payload.size()));
+		expect(out.get<binary_io::memory_ostream>().rdbuf(), 0, payload.size());
+		REQUIRE_THROWS_AS(binary_io::copy(in, out, 1), binary_io::buffer_exhausted);
+	}
+
+	SECTION("between files")
+	{
+		const std::filesystem::path src{ "copy_src_test.bin"sv };
+		const std::filesystem::path dst{ "copy_dst_test.bin"sv };
+		{
+			binary_io::file_ostream out{ src };
+			out.write_bytes(std::span{ payload });
+		}
+
+		{
+			binary_io::file_istream in{ src };
+			binary_io::file_ostream out{ dst };
+			out.write(std::uint8_t{ 0xEE });  // buffered, and must land before the copy
+			in.seek_absolute(3);
+			binary_io::copy(in, out, payload.size() - 10);
+			REQUIRE(in.tell() == static_cast<binary_io::streamoff>(payload.size() - 7));
+			REQUIRE(out.tell() == static_cast<binary_io::streamoff>(payload.size() - 9));
+			out.write(std::uint8_t{ 0xFF });
+			REQUIRE_THROWS_AS(binary_io::copy(in, out, 8), binary_io::buffer_exhausted);
+			REQUIRE(in.tell() == static_cast<binary_io::streamoff>(payload.size()));
+		}
+
+		binary_io::memory_ostream contents;
+		binary_io::file_istream in{ dst };
+		binary_io::copy(in, contents, std::filesystem::file_size(dst));
+		const auto& bytes = contents.rdbuf();
+		REQUIRE(bytes.size() == payload.size() - 1);
+		REQUIRE(bytes.front() == std::byte{ 0xEE });
+		expect(std::span{ bytes }.subspan(1, payload.size() - 10), 3, payload.size() - 10);
+		REQUIRE(bytes[payload.size() - 9] == std::byte{ 0xFF });
+		expect(std::span{ bytes }.last(7), payload.size() - 7, 7);
+	}
+
+#ifndef _WIN32
+	SECTION("between pipes and files")
+	{
+		const std::filesystem::path src{ "copy_pipe_src_test.bin"sv };
+		const std::filesystem::path dst{ "copy_pipe_dst_test.bin"sv };
+		{
+			binary_io::file_ostream out{ src };
+			out.write_bytes(std::span{ payload });
+		}
+
+		std::array<int, 2> fds{};
+		REQUIRE(::pipe(fds.data()) == 0);
+
+		binary_io::streamoff sent = 0;
+		std::thread producer{ [&]() {
+			binary_io::file_istream in{ src };
+			binary_io::pipe_ostream out{ fds[1] };
+			out.write(std::uint8_t{ 0xEE });  // buffered, and must be flushed before the copy
+			in.seek_absolute(3);
+			binary_io::copy(in, out, payload.size() - 3);
+			sent = out.tell();
+		} };
+
+		{
+			binary_io::pipe_istream in{ fds[0] };
+			REQUIRE(in.read<std::uint8_t>() == std::make_tuple(0xEE));  // buffers more than it reads
+			binary_io::file_ostream out{ dst };
+			out.write(std::uint8_t{ 0xFF });
+			binary_io::copy(in, out, payload.size() - 4);
+			REQUIRE(in.tell() == static_cast<binary_io::streamoff>(payload.size() - 3));
+			REQUIRE(out.tell() == static_cast<binary_io::streamoff>(payload.size() - 3));
+			producer.join();
+			REQUIRE(sent == static_cast<binary_io::streamoff>(payload.size() - 2));
+			REQUIRE_THROWS_AS(binary_io::copy(in, out, 2), binary_io::buffer_exhausted);
+		}
+
+		binary_io::memory_ostream contents;
+		binary_io::file_istream in{ dst };
+		binary_io::copy(in, contents, std::filesystem::file_size(dst));
+		const auto& bytes = contents.rdbuf();
+		REQUIRE(bytes.size() == payload.size() - 2);
+		REQUIRE(bytes.front() == std::byte{ 0xFF });
+		expect(std::span{ bytes }.subspan(1), 3, payload.size() - 3);
+	}
+#endif
+}
+
+#ifndef _WIN32
+TEST_CASE("pipe streams parse data as it arrives")
+{
+	STATIC_REQUIRE(binary_io::concepts::sequential_input_stream<binary_io::pipe_istream>);
+	STATIC_REQUIRE(!binary_io::concepts::input_stream<binary_io::pipe_istream>);
+	STATIC_REQUIRE(binary_io::concepts::sequential_output_stream<binary_io::pipe_ostream>);
+	STATIC_REQUIRE(!binary_io::concepts::output_stream<binary_io::pipe_ostream>);
+	STATIC_REQUIRE(binary_io::concepts::flushable_stream<binary_io::pipe_ostream>);
+	STATIC_REQUIRE(!binary_io::concepts::buffered_stream<binary_io::pipe_ostream>);
+	STATIC_REQUIRE(binary_io::concepts::buffered_stream<binary_io::file_ostream>);
+
+	std::array<int, 2> fds{};
+	REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds.data()) == 0);
+
+	std::array<std::byte, 64> large{};
+	for (std::size_t i = 0; i < large.size(); ++i) {
+		large[i] = static_cast<std::byte>(i);
+	}
+
+	binary_io::pipe_istream in{ fds[1], 8 };
+	{
+		binary_io::pipe_ostream out{ fds[0], 4 };
+		REQUIRE(out.is_open());
+		out.endian(std::endian::big);
+		out.write(std::uint8_t{ 0x01 }, std::uint16_t{ 0x0203 });
+		out.write(std::uint32_t{ 0x04050607 });
+		out.write_bytes(std::span{ large });
+		out.write(std::uint8_t{ 0xFF });
+		REQUIRE(out.tell() == 72);
+
+		auto moved = std::move(out);
+		REQUIRE(!out.is_open());
+		REQUIRE(moved.native_handle() == fds[0]);
+	}
+
+	in.endian(std::endian::big);
+	REQUIRE(!in.at_end());
+	REQUIRE(in.read<std::uint8_t, std::uint16_t, std::uint32_t>() == std::make_tuple(0x01, 0x0203, 0x04050607));
+
+	binary_io::memory_ostream copied;
+	binary_io::copy(in, copied, large.size());
+	REQUIRE(std::ranges::equal(copied.rdbuf(), large));
+	REQUIRE(in.tell() == 71);
+
+	REQUIRE(in.read<std::uint8_t>() == std::make_tuple(0xFF));
+	REQUIRE(in.at_end());
+	REQUIRE_THROWS_AS(in.read<std::uint8_t>(), binary_io::buffer_exhausted);
+
+	in.close();
+	REQUIRE(!in.is_open());
+
+	// a socket whose peer has gone reports an error, rather than raising SIGPIPE
+	REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds.data()) == 0);
+	::close(fds[1]);
+	binary_io::pipe_ostream orphan{ fds[0], 4 };
+	REQUIRE_THROWS_AS(orphan.write_bytes(std::span{ large }), std::system_error);
+}
+#endif
+
+#if BINARY_IO_OS_LINUX
+TEST_CASE("ring streams pass data through shared memory")
+{
+	STATIC_REQUIRE(binary_io::concepts::sequential_input_stream<binary_io::ring_istream>);
+	STATIC_REQUIRE(binary_io::concepts::contiguous_output_stream<binary_io::ring_ostream>);
+
+	binary_io::ring_ostream out;
+	out.create(1);
+	REQUIRE(out.is_open());
+	REQUIRE(out.capacity() >= 1);
+	REQUIRE_THROWS_AS(out.prepare(out.capacity() + 1), binary_io::buffer_exhausted);
+
+	binary_io::ring_istream in;
+	in.open(::dup(out.native_handle()));
+	REQUIRE(in.capacity() == out.capacity());
+
+	// several times the capacity, so the ring wraps around mid-value
+	constexpr std::uint32_t count = 100'000;
+	std::thread producer{ [&]() {
+		std::array<std::byte, 1000> block{};
+		for (std::uint32_t i = 0; i < count; ++i) {
+			out.write(std::uint8_t{ 0xAB }, i);
+			if (i % 1000 == 0) {
+				block.fill(static_cast<std::byte>(i / 1000));
+				out.write_bytes(std::span{ block });
+			}
+		}
+		out.close();
+	} };
+
+	bool ok = true;
+	std::array<std::byte, 1000> block{};
+	for (std::uint32_t i = 0; i < count && ok; ++i) {
+		ok = in.read<std::uint8_t, std::uint32_t>() == std::make_tuple(0xAB, i);
+		if (i % 1000 == 0) {
+			in.read_bytes(std::span{ block });
+			ok = ok && std::ranges::all_of(block, [&](std::byte a_byte) { return a_byte == static_cast<std::byte>(i / 1000); });
+		}
+	}
+	producer.join();
+
+	REQUIRE(ok);
+	REQUIRE(in.at_end());
+	REQUIRE(in.tell() == static_cast<binary_io::streamoff>(count * 5 + count));
+	REQUIRE_THROWS_AS(in.read<std::uint8_t>(), binary_io::buffer_exhausted);
+
+	out.create(1);
+	in.open(::dup(out.native_handle()));
+	in.close();
+	REQUIRE_THROWS_AS(out.write(std::uint8_t{ 0 }), std::system_error);
+
+	// memory which is merely the right shape is not a ring
+	const auto bogus = ::memfd_create("not_a_ring", MFD_CLOEXEC);
+	REQUIRE(bogus != -1);
+	REQUIRE(::ftruncate(bogus, static_cast<::off_t>(2 * ::sysconf(_SC_PAGESIZE))) == 0);
+	REQUIRE_THROWS_AS(in.open(bogus), std::system_error);
+	REQUIRE(!in.is_open());
+}
+#endif
+
+TEST_CASE("streams agree on random operation sequences")
+{
+	const std::filesystem::path path{ "differential_test.bin"sv };
+	std::mt19937 rng{ 0x5EED };
+	std::uniform_int_distribution<unsigned> byte{ 0, 255 };
+	std::vector<std::byte> program(512);
+
+	for (std::size_t i = 0; i < 256; ++i) {
+		for (auto& b : program) {
+			b = static_cast<std::byte>(byte(rng));
+		}
+		REQUIRE_NOTHROW(differential::run(program, i % 8 == 0 ? &path : nullptr));
+	}
+}
@@ -0,0 +1,411 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "binary_io/binary_io.hpp"
+
+// A differential tester which interprets an arbitrary byte string as a sequence of stream
+// operations, applies them to every stream type as well as a trivial reference model, and
+// throws differential::mismatch as soon as any of them disagree.
+namespace differential
+{
+	class mismatch :
+		public std::logic_error
+	{
+	public:
+		using std::logic_error::logic_error;
+	};
+
+	// the largest stream the program may build, which is also the capacity of the span streams
+	inline constexpr std::size_t capacity = 1024;
+
+	namespace detail
+	{
+		inline void check(bool a_condition, const char* a_what)
+		{
+			if (!a_condition) {
+				throw differential::mismatch(a_what);
+			}
+		}
+
+		class program
+		{
+		public:
+			explicit program(std::span<const std::byte> a_bytes) noexcept :
+				_bytes(a_bytes)
+			{}
+
+			[[nodiscard]] bool empty() const noexcept { return this->_pos >= this->_bytes.size(); }
+
+			template <class T>
+			[[nodiscard]] T next() noexcept
+			{
+				std::array<std::byte, sizeof(T)> buf{};
+				const auto len = std::min(buf.size(), this->_bytes.size() - std::min(this->_pos, this->_bytes.size()));
+				if (len > 0) {
+					std::memcpy(buf.data(), this->_bytes.data() + this->_pos, len);
+				}
+				this->_pos += sizeof(T);
+				return binary_io::endian::load<std::endian::little, T>(std::span{ buf });
+			}
+
+			[[nodiscard]] std::vector<std::byte> next_bytes(std::size_t a_count)
+			{
+				std::vector<std::byte> result(a_count);
+				for (auto& b : result) {
+					b = static_cast<std::byte>(this->next<std::uint8_t>() ^ 0xA5);
+				}
+				return result;
+			}
+
+			[[nodiscard]] std::endian next_endian() noexcept
+			{
+				return (this->next<std::uint8_t>() & 1) != 0 ? std::endian::big : std::endian::little;
+			}
+
+			[[nodiscard]] binary_io::streamoff next_offset() noexcept
+			{
+				// biased towards the interesting region around the end of the stream
+				return static_cast<binary_io::streamoff>(this->next<std::int16_t>() % static_cast<std::int16_t>(capacity + 64));
+			}
+
+		private:
+			std::span<const std::byte> _bytes;
+			std::size_t _pos{ 0 };
+		};
+
+		// the reference model all streams are compared against
+		struct model
+		{
+			void seek_absolute(binary_io::streamoff a_pos) noexcept { this->pos = std::max<binary_io::streamoff>(a_pos, 0); }
+			void seek_relative(binary_io::streamoff a_off) noexcept { this->seek_absolute(this->pos + a_off); }
+
+			[[nodiscard]] bool fits(std::size_t a_count) const noexcept
+			{
+				return a_count == 0 || static_cast<std::size_t>(this->pos) + a_count <= capacity;
+			}
+
+			void write(std::span<const std::byte> a_src)
+			{
+				if (a_src.empty()) {
+					return;
+				}
+
+				const auto where = static_cast<std::size_t>(this->pos);
+				if (where + a_src.size() > this->bytes.size()) {
+					this->bytes.resize(where + a_src.size());
+				}
+				std::copy(a_src.begin(), a_src.end(), this->bytes.begin() + static_cast<std::ptrdiff_t>(where));
+				this->pos += static_cast<binary_io::streamoff>(a_src.size());
+			}
+
+			[[nodiscard]] std::optional<std::vector<std::byte>> read(std::size_t a_count)
+			{
+				if (a_count == 0) {
+					return std::vector<std::byte>{};
+				}
+
+				const auto where = static_cast<std::size_t>(this->pos);
+				if (where > this->bytes.size() || this->bytes.size() - where < a_count) {
+					return std::nullopt;
+				}
+				this->pos += static_cast<binary_io::streamoff>(a_count);
+				const auto first = this->bytes.begin() + static_cast<std::ptrdiff_t>(where);
+				return std::vector<std::byte>(first, first + static_cast<std::ptrdiff_t>(a_count));
+			}
+
+			std::vector<std::byte> bytes;
+			binary_io::streamoff pos{ 0 };
+		};
+
+		template <class F, class... Streams>
+		void for_each(F&& a_func, Streams&... a_streams)
+		{
+			(a_func(a_streams), ...);
+		}
+
+		template <class... Streams>
+		void check_tell(const model& a_model, const Streams&... a_streams)
+		{
+			detail::check(((a_streams.tell() == a_model.pos) && ...), "tell() disagrees with the model");
+		}
+
+		template <class Stream>
+		[[nodiscard]] bool throws_exhausted(Stream& a_stream, std::span<std::byte> a_dst)
+		{
+			try {
+				a_stream.read_bytes(a_dst);
+				return false;
+			} catch (const binary_io::buffer_exhausted&) {
+				return true;
+			}
+		}
+
+		inline std::vector<std::byte> run_output(
+			program& a_program,
+			const std::filesystem::path* a_file)
+		{
+			model m;
+			std::vector<std::byte> spanBuffer(capacity);
+			binary_io::span_ostream span{ std::span{ spanBuffer } };
+			binary_io::memory_ostream memory;
+			binary_io::any_ostream any{ std::in_place_type<binary_io::memory_ostream> };
+			std::optional<binary_io::file_ostream> file;
+			std::optional<binary_io::mapped_file_ostream> mapped;
+			auto mappedPath = a_file ? *a_file : std::filesystem::path{};
+			if (a_file) {
+				file.emplace(*a_file);
+				mapped.emplace(mappedPath.replace_extension(".mapped"));
+			}
+
+			const auto apply = [&](auto&& a_func) {
+				a_func(span);
+				a_func(memory);
+				a_func(any);
+				if (file) {
+					a_func(*file);
+					a_func(*mapped);
+				}
+			};
+
+			for (std::size_t ops = 0; ops < 64 && !a_program.empty(); ++ops) {
+				switch (a_program.next<std::uint8_t>() % 5) {
+				case 0:
+					{
+						const auto bytes = a_program.next_bytes(a_program.next<std::uint8_t>() % 64);
+						if (m.fits(bytes.size())) {
+							m.write(bytes);
+							apply([&](auto& a_stream) { a_stream.write_bytes(std::span{ bytes }); });
+						} else {
+							const auto pos = span.tell();
+							bool threw = false;
+							try {
+								span.write_bytes(std::span{ bytes });
+							} catch (const binary_io::buffer_exhausted&) {
+								threw = true;
+							}
+							detail::check(threw && span.tell() == pos, "span_ostream did not reject an overflowing write");
+						}
+					}
+					break;
+				case 1:
+					{
+						const auto endian = a_program.next_endian();
+						const auto u8 = a_program.next<std::uint8_t>();
+						const auto u16 = a_program.next<std::uint16_t>();
+						const auto u32 = a_program.next<std::uint32_t>();
+						const auto u64 = a_program.next<std::uint64_t>();
+						if (m.fits(15)) {
+							std::array<std::byte, 15> encoded{};
+							const auto dst = std::span{ encoded };
+							binary_io::write(dst.subspan<0, 1>(), u8, endian);
+							binary_io::write(dst.subspan<1, 2>(), u16, endian);
+							binary_io::write(dst.subspan<3, 4>(), u32, endian);
+							binary_io::write(dst.subspan<7, 8>(), u64, endian);
+							m.write(encoded);
+							apply([&](auto& a_stream) { a_stream.write(endian, u8, u16, u32, u64); });
+						}
+					}
+					break;
+				case 2:
+					{
+						const auto pos = a_program.next_offset();
+						m.seek_absolute(pos);
+						apply([&](auto& a_stream) { a_stream.seek_absolute(pos); });
+					}
+					break;
+				case 3:
+					{
+						const auto off = a_program.next_offset() / 4;
+						m.seek_relative(off);
+						apply([&](auto& a_stream) { a_stream.seek_relative(off); });
+					}
+					break;
+				default:
+					break;
+				}
+
+				detail::check_tell(m, span, memory, any);
+				if (file) {
+					detail::check_tell(m, *file, *mapped);
+				}
+			}
+
+			const auto& expected = m.bytes;
+			detail::check(
+				std::equal(expected.begin(), expected.end(), spanBuffer.begin()) &&
+					std::all_of(spanBuffer.begin() + static_cast<std::ptrdiff_t>(expected.size()), spanBuffer.end(), [](std::byte a_byte) { return a_byte == std::byte{ 0 }; }),
+				"span_ostream contents disagree with the model");
+			detail::check(memory.rdbuf() == expected, "memory_ostream contents disagree with the model");
+			detail::check(any.get<binary_io::memory_ostream>().rdbuf() == expected, "any_ostream contents disagree with the model");
+			if (file) {
+				file->close();
+				detail::check(std::filesystem::file_size(*a_file) == expected.size(), "file_ostream size disagrees with the model");
+				detail::check(std::ranges::equal(mapped->rdbuf(), expected), "mapped_file_ostream contents disagree with the model");
+				mapped->close();
+				detail::check(std::filesystem::file_size(mappedPath) == expected.size(), "mapped_file_ostream size disagrees with the model");
+			}
+
+			return expected;
+		}
+
+		inline void run_input(
+			program& a_program,
+			std::span<const std::byte> a_contents,
+			const std::filesystem::path* a_file)
+		{
+			model m;
+			m.bytes.assign(a_contents.begin(), a_contents.end());
+			binary_io::span_istream span{ a_contents };
+			binary_io::memory_istream memory{ std::in_place, a_contents.begin(), a_contents.end() };
+			binary_io::any_istream any{ std::in_place_type<binary_io::span_istream>, a_contents };
+			std::optional<binary_io::file_istream> file;
+			if (a_file) {
+				file.emplace(*a_file);
+			}
+
+			const auto apply = [&](auto&& a_func) {
+				a_func(span);
+				a_func(memory);
+				a_func(any);
+				if (file) {
+					a_func(*file);
+				}
+			};
+
+			// a failed read may leave streams at different positions, so put them back in sync
+			const auto resync = [&]() {
+				apply([&](auto& a_stream) { a_stream.seek_absolute(m.pos); });
+			};
+
+			for (std::size_t ops = 0; ops < 64 && !a_program.empty(); ++ops) {
+				switch (a_program.next<std::uint8_t>() % 5) {
+				case 0:
+					{
+						const auto count = a_program.next<std::uint8_t>() % 64;
+						const auto expected = m.read(count);
+						apply([&](auto& a_stream) {
+							std::vector<std::byte> actual(count);
+							if (expected) {
+								a_stream.read_bytes(std::span{ actual });
+								detail::check(actual == *expected, "read_bytes() disagrees with the model");
+							} else {
+								detail::check(
+									count > 0 && detail::throws_exhausted(a_stream, std::span{ actual }),
+									"read_bytes() did not report exhaustion");
+							}
+						});
+						if (!expected) {
+							resync();
+						}
+					}
+					break;
+				case 1:
+					{
+						const auto endian = a_program.next_endian();
+						const auto expected = m.read(15);
+						if (expected) {
+							const auto src = std::span{ *expected };
+							const auto values = std::make_tuple(
+								binary_io::read<std::uint8_t>(src.subspan<0, 1>(), endian),
+								binary_io::read<std::uint16_t>(src.subspan<1, 2>(), endian),
+								binary_io::read<std::uint32_t>(src.subspan<3, 4>(), endian),
+								binary_io::read<std::uint64_t>(src.subspan<7, 8>(), endian));
+							apply([&](auto& a_stream) {
+								const auto actual = a_stream.template read<std::uint8_t, std::uint16_t, std::uint32_t, std::uint64_t>(endian);
+								detail::check(actual == values, "batched read() disagrees with the model");
+							});
+						} else {
+							apply([&](auto& a_stream) {
+								bool threw = false;
+								try {
+									(void)a_stream.template read<std::uint8_t, std::uint16_t, std::uint32_t, std::uint64_t>(endian);
+								} catch (const binary_io::buffer_exhausted&) {
+									threw = true;
+								}
+								detail::check(threw, "batched read() did not report exhaustion");
+							});
+							resync();
+						}
+					}
+					break;
+				case 2:
+					{
+						const auto pos = a_program.next_offset();
+						m.seek_absolute(pos);
+						apply([&](auto& a_stream) { a_stream.seek_absolute(pos); });
+					}
+					break;
+				case 3:
+					{
+						const auto off = a_program.next_offset() / 4;
+						m.seek_relative(off);
+						apply([&](auto& a_stream) { a_stream.seek_relative(off); });
+					}
+					break;
+				case 4:
+					{
+						const auto count = a_program.next<std::uint8_t>() % 64;
+						const auto expected = m.read(count);
+						for_each(
+							[&](auto& a_stream) {
+								if (expected) {
+									const auto actual = a_stream.read_bytes(count);
+									detail::check(std::ranges::equal(actual, *expected), "no-copy read_bytes() disagrees with the model");
+								} else {
+									bool threw = false;
+									try {
+										(void)a_stream.read_bytes(count);
+									} catch (const binary_io::buffer_exhausted&) {
+										threw = true;
+									}
+									detail::check(count > 0 && threw, "no-copy read_bytes() did not report exhaustion");
+								}
+							},
+							span,
+							memory);
+						if (expected) {
+							any.seek_relative(static_cast<binary_io::streamoff>(count));
+							if (file) {
+								file->seek_relative(static_cast<binary_io::streamoff>(count));
+							}
+						} else {
+							resync();
+						}
+					}
+					break;
+				default:
+					break;
+				}
+
+				detail::check_tell(m, span, memory, any);
+				if (file) {
+					detail::check_tell(m, *file);
+				}
+			}
+		}
+	}
+
+	// Runs the given program against every stream type. When a path is given, file streams
+	// participate as well, using that path as scratch space.
+	inline void run(
+		std::span<const std::byte> a_program,
+		const std::filesystem::path* a_file = nullptr)
+	{
+		detail::program program{ a_program };
+		const auto contents = detail::run_output(program, a_file);
+		detail::run_input(program, contents, a_file);
+	}
+}